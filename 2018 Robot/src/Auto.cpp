@@ -1,7 +1,5 @@
 #include "Robot.h"
 
-std::string WaitForGameData();
-
 /*
  * Fix Measurements for:
  * 	Same Side Scale                   (NEEDS TESTING) (NEEDS ELEVATOR)
@@ -15,466 +13,667 @@ std::string WaitForGameData();
 void Robot::AutonomousInit()
 {
 	StopCurrentProcesses();
+	m_robotMode = AUTONOMOUS_MODE;
+	ResetTiming(m_autonomousTiming);
+	m_matchRecorder.Rotate(GetMatchLogName("Auto"));
+	m_traceName = GetMatchLogName("Auto");
+
+	// Make sure the plans exist before the listener is armed, in case the robot was enabled in
+	// auto without ever being disabled. The listener never builds plans itself
+	UpdateAutoPlans();
+
+	// Start the precomputed plan right away if the game data is already here. Otherwise the
+	// GameDataListener starts it as soon as the driver station packet with the data arrives,
+	// and AutonomousPeriodic falls back to the baseline if it never does
+	{
+		std::lock_guard<std::recursive_mutex> lock(m_autoPlanMutex);
+		m_isWaitingForGameData = true;
+		m_gameDataTimer.Reset();
+		m_gameDataTimer.Start();
+	}
+	m_gameDataListener.Arm();
+	StartAutoPlanIfReady(DriverStation::GetInstance().GetGameSpecificMessage(), true);
+}
+
+void Robot::AutonomousPeriodic()
+{
+	ScopedLoopTimer timing(m_autonomousTiming);
+	std::lock_guard<std::mutex> lock(m_autoStepMutex);
+	UpdateSnapshot();
+
+	StartAutoPlanIfReady(DriverStation::GetInstance().GetGameSpecificMessage(), true);
+	m_autoScheduler.Run();
+
+	m_telemetry.SetNumber(m_telemetrySlots.angle, m_snapshot.angle);
+	m_telemetry.SetBoolean(m_telemetrySlots.isNavXConnected, AngleSensors.IsNavXConnected());
+	m_telemetry.SetNumber(m_telemetrySlots.distance, m_snapshot.leftDriveDistance);
+	m_telemetry.SetNumber(m_telemetrySlots.driveVelocity, m_snapshot.leftDriveVelocity);
+	m_telemetry.SetNumber(m_telemetrySlots.driveAcceleration, m_snapshot.leftDriveAcceleration);
+	m_telemetry.SetNumber(m_telemetrySlots.elevatorVelocity, m_snapshot.elevatorVelocity);
+}
 
-	// Get the game data from the FMS
-	std::string gameData;
-	try
+// Called from the GameDataListener thread. The first step of the precomputed plan runs from
+// here instead of waiting up to a robot period for AutonomousPeriodic. m_autoStepMutex keeps
+// it from overlapping the main loop, so the commands can read the snapshot and sensors as usual
+void Robot::OnGameData(std::string gameData)
+{
+	double arrivalTime = Timer::GetFPGATimestamp();
+	std::lock_guard<std::mutex> lock(m_autoStepMutex);
+	if(StartAutoPlanIfReady(gameData, false))
 	{
-		gameData = WaitForGameData();
+		m_autoScheduler.Run();
+		SmartDashboard::PutNumber("Game Data To Motion (ms)", (Timer::GetFPGATimestamp() - arrivalTime) * 1000);
 	}
-	catch(const char* error)
+}
+
+// Index of the plan for a given field layout: bit 1 is set if our switch plate is on the
+// right and bit 0 is set if our scale plate is on the right (LL = 0, LR = 1, RL = 2, RR = 3)
+int GetAutoPlanIndex(const std::string& gameData)
+{
+	if(gameData.length() < 2) return -1;
+	if(gameData[0] != 'L' && gameData[0] != 'R') return -1;
+	if(gameData[1] != 'L' && gameData[1] != 'R') return -1;
+
+	return (gameData[0] == 'R' ? 2 : 0) + (gameData[1] == 'R' ? 1 : 0);
+}
+
+// Rebuild the cached auto plans (including their motion profiles) whenever the
+// auto selection on the dashboard changes
+void Robot::UpdateAutoPlans()
+{
+	std::lock_guard<std::recursive_mutex> lock(m_autoPlanMutex);
+
+	// The summary is only rebuilt when one of the choosers changes, instead of every disabled loop
+	bool hasSelectionChanged = AutoLocationChooser.Update();
+	hasSelectionChanged |= AutoObjectiveChooser.Update();
+	hasSelectionChanged |= SwitchApproachChooser.Update();
+	if(hasSelectionChanged)
 	{
-		// If we didn't receive any game data, drive to the baseline
-		DriverStation::GetInstance().ReportError(error);
+		m_telemetry.SetString(m_telemetrySlots.autoSettings, AutoLocationChooser.GetSelectedLabel() + ", " +
+				AutoObjectiveChooser.GetSelectedLabel() + ", Switch Approach: " + SwitchApproachChooser.GetSelectedLabel());
+	}
+
+	consts::AutoPosition position = AutoLocationChooser.GetSelected();
+	consts::AutoObjective objective = AutoObjectiveChooser.GetSelected();
+	consts::SwitchApproach approach = SwitchApproachChooser.GetSelected();
+	double delay = SmartDashboard::GetNumber("Auto Delay", 0);
 
-		Wait(SmartDashboard::GetNumber("Auto Delay", 0));
-		DriveToBaseline();
+	if(m_areAutoPlansReady && position == m_plannedPosition && objective == m_plannedObjective &&
+			approach == m_plannedApproach && delay == m_plannedDelay)
+	{
 		return;
 	}
 
+	m_plannedPosition = position;
+	m_plannedObjective = objective;
+	m_plannedApproach = approach;
+	m_plannedDelay = delay;
+
+	const std::string fieldLayouts[consts::NUM_FIELD_LAYOUTS] = {"LL", "LR", "RL", "RR"};
+	for(int i = 0; i < consts::NUM_FIELD_LAYOUTS; i++)
+	{
+		m_autoPlans[i] = BuildAutoRoutine(position, objective, approach, delay, fieldLayouts[i], m_autoPlanNames[i]);
+	}
+
+	// If we never receive any game data, drive to the baseline
+	auto baselineRoutine = std::make_unique<AutoSequence>();
+	baselineRoutine->Add(std::make_unique<WaitCommand>(delay));
+	baselineRoutine->Add(DriveToBaseline());
+	m_baselinePlan = std::move(baselineRoutine);
+
+	m_areAutoPlansReady = true;
+}
+
+// Returns true if this call started the auto plan. Off the main thread it only starts a plan
+// that's already built, and leaves anything else to the next robot loop
+bool Robot::StartAutoPlanIfReady(std::string gameData, bool isMainThread)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_autoPlanMutex);
+
+	// Give up on the game data after some timeout period
+	if(!m_isWaitingForGameData ||
+			(gameData.length() == 0 && !m_gameDataTimer.HasPeriodPassed(consts::GAME_DATA_TIMEOUT_S)))
+	{
+		return false;
+	}
+
+	int planIndex = GetAutoPlanIndex(gameData);
+	if(!isMainThread && (planIndex < 0 || !m_areAutoPlansReady)) return false;
+
+	m_isWaitingForGameData = false;
+	m_gameDataListener.Disarm();
+	m_gameDataTimer.Stop();
+
+	// Plans are normally built while disabled or in AutonomousInit, but make sure they exist.
+	// The GameDataListener never builds them, since that reads the dashboard
+	if(isMainThread) UpdateAutoPlans();
+
+	if(gameData.length() == 0)
+	{
+		DriverStation::GetInstance().ReportError("Unable to read game data. Driving to Baseline");
+		SmartDashboard::PutString("Auto Path", "No Game Data: Drive to Baseline");
+		m_autoScheduler.Start(std::move(m_baselinePlan));
+	}
+	else if(planIndex >= 0)
+	{
+		SmartDashboard::PutString("Auto Path", m_autoPlanNames[planIndex]);
+		m_autoScheduler.Start(std::move(m_autoPlans[planIndex]));
+	}
+	else
+	{
+		std::string pathName;
+		m_autoScheduler.Start(BuildAutoRoutine(m_plannedPosition, m_plannedObjective, m_plannedApproach,
+				m_plannedDelay, gameData, pathName));
+		SmartDashboard::PutString("Auto Path", pathName);
+	}
+
+	// One of the plans was moved into the scheduler, so they have to be rebuilt for the next match
+	m_areAutoPlansReady = false;
+	return true;
+}
+
+AutoCommandPtr Robot::BuildAutoRoutine(consts::AutoPosition position, consts::AutoObjective objective,
+		consts::SwitchApproach approach, double delay, std::string gameData, std::string& pathName)
+{
 	// Add an optional delay to account for other robot auto paths
-	Wait(SmartDashboard::GetNumber("Auto Delay", 0));
+	auto routine = std::make_unique<AutoSequence>();
+	routine->SetName("Auto Routine");
+	routine->Add(std::make_unique<WaitCommand>(delay));
 
-	switch(AutoLocationChooser->GetSelected())
+	switch(position)
 	{
 		case consts::AutoPosition::LEFT_START:
-			switch(AutoObjectiveChooser->GetSelected())
+			switch(objective)
 			{
 				case consts::AutoObjective::SWITCH:
 					if(gameData[0] == 'L')
 					{
-						SmartDashboard::PutString("Auto Path", "Left: Path to Switch " + gameData[0]);
-						SidePath(consts::AutoPosition::LEFT_START, gameData[0], gameData[1]);
+						pathName = std::string("Left: Path to Switch ") + gameData[0];
+						routine->Add(SidePath(consts::AutoPosition::LEFT_START, approach, gameData[0], gameData[1]));
 					}
 //					else if(gameData[0] == 'R')
 //					{
-//						SmartDashboard::PutString("Auto Path", "Left: Path to Switch" + gameData[0]);
-//						OppositeSwitch(consts::AutoPosition::LEFT_START);
+//						pathName = std::string("Left: Path to Switch ") + gameData[0];
+//						OppositeSwitch(consts::AutoPosition::LEFT_START, approach);
 //					}
 					else
 					{
-						SmartDashboard::PutString("Auto Path", "Left: Drive to Baseline");
-						DriveToBaseline();
+						pathName = "Left: Drive to Baseline";
+						routine->Add(DriveToBaseline());
 					}
 					break;
 				case consts::AutoObjective::SCALE:
 					if(gameData[1] == 'L')
 					{
-						SmartDashboard::PutString("Auto Path", "Left: Path to Scale " + gameData[1]);
-						SidePath(consts::AutoPosition::LEFT_START, 'N', gameData[1]);
+						pathName = std::string("Left: Path to Scale ") + gameData[1];
+						routine->Add(SidePath(consts::AutoPosition::LEFT_START, approach, 'N', gameData[1]));
 					}
 					else if(gameData[1] == 'R')
 					{
-						SmartDashboard::PutString("Auto Path", "Left: Path to Scale " + gameData[1]);
-						OppositeScale(consts::AutoPosition::LEFT_START);
+						pathName = std::string("Left: Path to Scale ") + gameData[1];
+						routine->Add(OppositeScale(consts::AutoPosition::LEFT_START));
 					}
 					else
 					{
-						SmartDashboard::PutString("Auto Path", "Left: Drive to Baseline");
-						DriveToBaseline();
+						pathName = "Left: Drive to Baseline";
+						routine->Add(DriveToBaseline());
 					}
 					break;
 				case consts::AutoObjective::BASELINE:
-					SmartDashboard::PutString("Auto Path", "Left: Drive to Baseline");
-					DriveToBaseline();
+					pathName = "Left: Drive to Baseline";
+					routine->Add(DriveToBaseline());
 					break;
 				case consts::AutoObjective::DEFAULT:
 				default:
-					SmartDashboard::PutString("Auto Path", "Left: Default Path");
-					SidePath(consts::AutoPosition::LEFT_START, gameData[0], gameData[1]);
+					pathName = "Left: Default Path";
+					routine->Add(SidePath(consts::AutoPosition::LEFT_START, approach, gameData[0], gameData[1]));
 					break;
 			}
 			break;
 
 		case consts::AutoPosition::RIGHT_START:
-			switch(AutoObjectiveChooser->GetSelected())
+			switch(objective)
 			{
 				case consts::AutoObjective::SWITCH:
 					if(gameData[0] == 'R')
 					{
-						SmartDashboard::PutString("Auto Path", "Right: Path to Switch " + gameData[0]);
-						SidePath(consts::AutoPosition::RIGHT_START, gameData[0], gameData[1]);
+						pathName = std::string("Right: Path to Switch ") + gameData[0];
+						routine->Add(SidePath(consts::AutoPosition::RIGHT_START, approach, gameData[0], gameData[1]));
 					}
 //					else if(gameData[0] == 'L')
 //					{
-//						SmartDashboard::PutString("Auto Path", "Right: Path to Switch " + gameData[0]);
-//						OppositeSwitch(consts::AutoPosition::RIGHT_START);
+//						pathName = std::string("Right: Path to Switch ") + gameData[0];
+//						OppositeSwitch(consts::AutoPosition::RIGHT_START, approach);
 //					}
 					else
 					{
-						SmartDashboard::PutString("Auto Path", "Right: Drive to Baseline");
-						DriveToBaseline();
+						pathName = "Right: Drive to Baseline";
+						routine->Add(DriveToBaseline());
 					}
 					break;
 				case consts::AutoObjective::SCALE:
 					if(gameData[1] == 'R')
 					{
-						SmartDashboard::PutString("Auto Path", "Right: Path to Scale " + gameData[1]);
-						SidePath(consts::AutoPosition::RIGHT_START, 'N', gameData[1]);
+						pathName = std::string("Right: Path to Scale ") + gameData[1];
+						routine->Add(SidePath(consts::AutoPosition::RIGHT_START, approach, 'N', gameData[1]));
 					}
 					else if(gameData[1] == 'L')
 					{
-						SmartDashboard::PutString("Auto Path", "Right: Path to Scale ");
-						OppositeScale(consts::AutoPosition::RIGHT_START);
+						pathName = std::string("Right: Path to Scale ") + gameData[1];
+						routine->Add(OppositeScale(consts::AutoPosition::RIGHT_START));
 					}
 					else
 					{
-						SmartDashboard::PutString("Auto Path", "Right: Drive to Baseline");
-						DriveToBaseline();
+						pathName = "Right: Drive to Baseline";
+						routine->Add(DriveToBaseline());
 					}
 					break;
 				case consts::AutoObjective::BASELINE:
-					SmartDashboard::PutString("Auto Path", "Right: Drive to Baseline");
-					DriveToBaseline();
+					pathName = "Right: Drive to Baseline";
+					routine->Add(DriveToBaseline());
 					break;
 				case consts::AutoObjective::DEFAULT:
 				default:
-					SmartDashboard::PutString("Auto Path", "Right: Default Path");
-					SidePath(consts::AutoPosition::RIGHT_START, gameData[0], gameData[1]);
+					pathName = "Right: Default Path";
+					routine->Add(SidePath(consts::AutoPosition::RIGHT_START, approach, gameData[0], gameData[1]));
 					break;
 			}
 			break;
 
 		case consts::AutoPosition::MIDDLE_START:
-			SmartDashboard::PutString("Auto Path", "Middle Switch");
-			MiddlePath(gameData[0]);
+			pathName = "Middle Switch";
+			routine->Add(MiddlePath(gameData[0]));
 			break;
 
 		default:
-			SmartDashboard::PutString("Auto Path", "Middle Switch");
-			MiddlePath(gameData[0]);
+			pathName = "Middle Switch";
+			routine->Add(MiddlePath(gameData[0]));
 			break;
 	}
+
+	return std::move(routine);
 }
 
-void Robot::AutonomousPeriodic()
+AutoCommandPtr Robot::AutoStatus(std::string status)
 {
-	SmartDashboard::PutNumber("Angle", AngleSensors.GetAngle());
-	SmartDashboard::PutNumber("Distance", PulsesToInches(FrontLeftMotor.GetSelectedSensorPosition(0)));
+	return std::make_unique<InstantCommand>([status]() {
+		SmartDashboard::PutString("Auto Status", status);
+		Tracer::GetInstance().AddInstant(status.c_str(), "auto");
+	});
 }
 
-std::string WaitForGameData()
+AutoCommandPtr Robot::DriveToBaseline()
 {
-	std::string gameData;
-	Timer gameDataTimer;
-	gameDataTimer.Start();
-
-	// Poll for the game data for some timeout period or until we've received the data
-	while(gameData.length() == 0 && !gameDataTimer.HasPeriodPassed(consts::GAME_DATA_TIMEOUT_S))
-	{
-		gameData = DriverStation::GetInstance().GetGameSpecificMessage();
-		Wait(0.05);
-	}
-	gameDataTimer.Stop();
-
-	if(gameData.length() == 0)
-	{
-		throw "Unable to read game data. Driving to Baseline";
-	}
-	else
-	{
-		return gameData;
-	}
+	auto path = std::make_unique<AutoSequence>();
+	path->SetName("Drive To Baseline");
+	path->Add(AutoStatus("Crossing Baseline"));
+	path->Add(DriveDistance(150));
+	path->Add(AutoStatus("Finished crossing Baseline"));
+	return std::move(path);
 }
 
-void Robot::DriveToBaseline()
+AutoCommandPtr Robot::DriveDistance(double distance, double timeout)
 {
-	SmartDashboard::PutString("Auto Status", "Crossing Baseline");
-	DriveDistance(150);
-	SmartDashboard::PutString("Auto Status", "Finished crossing Baseline");
+	// The setpoint follows a velocity and acceleration limited profile instead of
+	// stepping straight to the distance, so the controller doesn't saturate at the start
+	MotionProfile profile(distance, consts::DRIVE_MAX_VELOCITY, consts::DRIVE_MAX_ACCELERATION, consts::DRIVE_MAX_JERK);
+
+	SettleDetector settleDetector(consts::DRIVE_SETTLE_TOLERANCE, consts::DRIVE_SETTLE_VELOCITY,
+			consts::SETTLE_DWELL_TIME_S, consts::STALL_TIME_S);
+
+	return Named("Drive Distance", std::make_unique<ProfileCommand>(profile, settleDetector,
+		[this, distance]() {
+			SmartDashboard::PutString("Auto Status", "Driving a Distance...");
+			//Disable other controllers
+			AngleController.Disable();
+
+			//Zeroing the angle sensor and encoders
+			ResetDriveEncoders();
+			AngleSensors.Reset();
+
+			//Disable test dist output for angle
+			AnglePIDOut.SetTestDistOutput(0);
+
+			//Configure the PID controller to make sure the robot drives straight with the NavX
+			MaintainAngleController.Reset();
+			MaintainAngleController.SetSetpoint(0);
+
+			//Configure the robot to start following the profile from where it is
+			DistanceController.Reset();
+			DistanceController.SetSetpoint(0);
+
+			MaintainAngleController.Enable();
+			DistanceController.Enable();
+
+			SmartDashboard::PutNumber("Target Distance", distance);
+		},
+		[this](const MotionState& state) {
+			// Ensure the robot doesn't drive at full speed while the elevator is up
+			double speedLimit = IsElevatorTooHigh() ? consts::DRIVE_SPEED_REDUCTION : 1.0;
+			DistanceController.SetOutputRange(-consts::DISTANCE_PID_MAX_OUTPUT * speedLimit,
+					consts::DISTANCE_PID_MAX_OUTPUT * speedLimit);
+
+			DistanceController.SetSetpoint(state.position);
+			DistancePID.SetFeedforward(speedLimit *
+					(consts::DRIVE_KV * state.velocity + consts::DRIVE_KA * state.acceleration));
+		},
+		//Wait until the PID controller has reached the target and the robot is steady
+		[this, distance]() { return distance - DistancePID.PIDGet(); },
+		[this]() { return m_snapshot.leftDriveVelocity; },
+		[this]() {
+			DistanceController.Disable();
+			DistancePID.SetFeedforward(0);
+			SmartDashboard::PutString("Auto Status", "Drive complete");
+		},
+		timeout));
 }
 
-//Wait until the PID controller has reached the target and the robot is steady
-void WaitUntilPIDSteady(PIDController& pidController, PIDSource& pidSource, double timeout)
+AutoCommandPtr Robot::TurnAngle(double angle, double timeout)
 {
-	Timer PIDTimer;
-	PIDTimer.Start();
-
-	do
-	{
-		Wait(0.01);
-	}
-	while(!pidController.OnTarget() && !PIDTimer.HasPeriodPassed(timeout));
-
-	PIDTimer.Stop();
-	pidController.Disable();
+	MotionProfile profile(angle, consts::TURN_MAX_VELOCITY, consts::TURN_MAX_ACCELERATION, consts::TURN_MAX_JERK);
+
+	SettleDetector settleDetector(consts::TURN_SETTLE_TOLERANCE, consts::TURN_SETTLE_VELOCITY,
+			consts::SETTLE_DWELL_TIME_S, consts::STALL_TIME_S);
+
+	return Named("Turn Angle", std::make_unique<ProfileCommand>(profile, settleDetector,
+		[this, angle]() {
+			SmartDashboard::PutString("Auto Status", "Rotating...");
+			//Disable other controllers
+			DistanceController.Disable();
+			MaintainAngleController.Disable();
+
+			//Zeroing the angle sensor
+			AngleSensors.Reset();
+
+			//Disable test dist output for angle
+			AnglePIDOut.SetTestDistOutput(0);
+
+			AngleController.Reset();
+			AngleController.SetSetpoint(0);
+			AngleController.Enable();
+
+			SmartDashboard::PutNumber("Target Angle", angle);
+		},
+		[this](const MotionState& state) {
+			AngleController.SetSetpoint(state.position);
+			AnglePIDOut.SetFeedforward(consts::TURN_KV * state.velocity + consts::TURN_KA * state.acceleration);
+		},
+		[this, angle]() { return angle - AngleSensors.GetAngle(); },
+		[this]() { return AngleSensors.GetRate(); },
+		[this]() {
+			AngleController.Disable();
+			AnglePIDOut.SetFeedforward(0);
+			SmartDashboard::PutString("Auto Status", "Rotation complete");
+		},
+		timeout));
 }
 
-void Robot::DriveDistance(double distance, double timeout)
+AutoCommandPtr Robot::DriveFor(double seconds, double speed)
 {
-	SmartDashboard::PutString("Auto Status", "Driving a Distance...");
-	//Disable other controllers
-	AngleController.Disable();
-
-	//Zeroing the angle sensor and encoders
-	ResetDriveEncoders();
-	AngleSensors.Reset();
-
-	//Disable test dist output for angle
-	AnglePIDOut.SetTestDistOutput(0);
-	//Make sure the PID objects know about each other to avoid conflicts
-	DistancePID.SetAnglePID(&AnglePIDOut);
-	AnglePIDOut.SetDistancePID(&DistancePID);
-
-	//Configure the PID controller to make sure the robot drives straight with the NavX
-	MaintainAngleController.Reset();
-	MaintainAngleController.SetSetpoint(0);
-
-	//Configure the robot to drive a given distance
-	DistanceController.Reset();
-	DistanceController.SetSetpoint(distance);
-
-	MaintainAngleController.Enable();
-	DistanceController.Enable();
-
-	SmartDashboard::PutNumber("Target Distance", distance);
-
-	WaitUntilPIDSteady(DistanceController, DistancePID, timeout);
-
-	SmartDashboard::PutString("Auto Status", "Drive complete");
+	// Keep sending the output every loop so the drive train's motor safety doesn't time out
+	return Named("Drive For", std::make_unique<FunctionCommand>(
+		nullptr,
+		[this, speed]() { DriveTrain.ArcadeDrive(speed, 0); },
+		nullptr,
+		[this]() { DriveTrain.ArcadeDrive(0, 0); },
+		seconds));
 }
 
-void Robot::TurnAngle(double angle, double timeout)
+//Raises elevator, places a power cube, and then lowers elevator
+AutoCommandPtr Robot::DropCube(consts::ElevatorIncrement elevatorSetpoint)
 {
-	SmartDashboard::PutString("Auto Status", "Rotating...");
-	//Disable other controllers
-	DistanceController.Disable();
-	MaintainAngleController.Disable();
+	auto drop = std::make_unique<AutoSequence>();
+	drop->SetName("Drop Cube");
+	drop->Add(AutoStatus("Dropping Cube..."));
 
-	//Zeroing the angle sensor
-	AngleSensors.Reset();
-
-	//Disable test dist output for angle
-	AnglePIDOut.SetTestDistOutput(0);
-
-	//Remove the pointers since only one PID is being used
-	DistancePID.SetAnglePID(nullptr);
-	AnglePIDOut.SetDistancePID(nullptr);
-
-	AngleController.Reset();
-	AngleController.SetSetpoint(angle);
-	AngleController.Enable();
-
-	SmartDashboard::PutNumber("Target Angle", angle);
+	// Paths usually raise the elevator in parallel with their last drive, in which
+	// case this finishes right away
+	if(elevatorSetpoint != consts::ElevatorIncrement::GROUND)
+	{
+		drop->Add(RaiseElevator(elevatorSetpoint));
+	}
 
-//	RightIntakeMotor.Set(consts::INTAKE_SPEED_WHILE_TURNING);
-//	LeftIntakeMotor.Set(-consts::INTAKE_SPEED_WHILE_TURNING);
+	drop->Add(EjectCube());
 
-	WaitUntilPIDSteady(AngleController, AngleSensors, timeout);
+	if(elevatorSetpoint != consts::ElevatorIncrement::GROUND)
+	{
+		drop->Add(RaiseElevator(consts::ElevatorIncrement::GROUND));
+	}
 
-//	RightIntakeMotor.Set(0);
-//	LeftIntakeMotor.Set(0);
+	// ElevatorMotors reset to 0
+	drop->Add(std::make_unique<InstantCommand>([this]() {
+		ElevatorPIDController.Disable();
+		RightElevatorMotor.Set(0);
+		LeftElevatorMotor.Set(0);
+	}));
 
-	SmartDashboard::PutString("Auto Status", "Rotation complete");;
+	drop->Add(AutoStatus("Cube Dropped"));
+	return std::move(drop);
 }
 
-void Robot::DriveFor(double seconds, double speed)
+AutoCommandPtr Robot::EjectCube(double intakeSpeed)
 {
-	DriveTrain.ArcadeDrive(speed, 0);
-	Wait(seconds);
-	DriveTrain.ArcadeDrive(0, 0);
+	auto eject = std::make_unique<AutoSequence>();
+	eject->SetName("Eject Cube");
+	eject->Add(AutoStatus("Ejecting Cube..."));
+	eject->Add(std::make_unique<InstantCommand>([this, intakeSpeed]() {
+		RightIntakeMotor.Set(-intakeSpeed);
+		LeftIntakeMotor.Set(intakeSpeed);
+	}));
+	eject->Add(std::make_unique<WaitCommand>(consts::INTAKE_WAIT_TIME));
+	eject->Add(std::make_unique<InstantCommand>([this]() {
+		LeftSolenoid.Set(DoubleSolenoid::Value::kReverse);
+		RightSolenoid.Set(DoubleSolenoid::Value::kReverse);
+	}));
+	eject->Add(std::make_unique<WaitCommand>(1.0 - consts::INTAKE_WAIT_TIME));
+	eject->Add(std::make_unique<InstantCommand>([this]() {
+		RightIntakeMotor.Set(0);
+		LeftIntakeMotor.Set(0);
+	}));
+	eject->Add(AutoStatus("Ejected Cube"));
+	return std::move(eject);
 }
 
-//Raises elevator, places a power cube, and then lowers elevator
-void Robot::DropCube(consts::ElevatorIncrement elevatorSetpoint)
+// Moves the elevator to a setpoint along a motion profile and keeps the PID enabled afterwards
+// so that it holds the elevator there while the rest of the routine runs
+AutoCommandPtr Robot::RaiseElevator(consts::ElevatorIncrement elevatorSetpoint, double timeout)
 {
-	SmartDashboard::PutString("Auto Status", "Dropping Cube...");
-//	RaiseElevator(elevatorSetpoint);
-
 	double elevatorHeight = consts::ELEVATOR_SETPOINTS[elevatorSetpoint];
-//	if(dabs(elevatorHeight - ElevatorPID.PIDGet()) > consts::ELEVATOR_PID_DEADBAND)
-//	{
-//		double error = elevatorHeight - ElevatorPID.PIDGet();
-//		while(error > 2)
-//		{
-//			bool inAuto = IsAutonomous();
-//			if(!inAuto)
-//			{
-//				RightElevatorMotor.Set(0);
-//				LeftElevatorMotor.Set(0);
-//				return;
-//			}
-
-//			//To avoid damage, use basic p-control with an added constant output speed of 0.5
-//			error = elevatorHeight - ElevatorPID.PIDGet();
-//			RightElevatorMotor.Set(limit(error * 0.03 + 0.5, 0.8));
-//			LeftElevatorMotor.Set(limit(error * 0.03 + 0.5, 0.8));
-//		}
-//
-//		// ElevatorMotors set to a slow but constant speed to keep the elevator from falling
-//		// due to gravity
-//		RightElevatorMotor.Set(0.25);
-//		LeftElevatorMotor.Set(0.25);
-////	}
-//
-//	// ElevatorMotors reset to 0
-//	RightElevatorMotor.Set(0);
-//	LeftElevatorMotor.Set(0);
-	EjectCube();
-
-	// ElevatorMotors reset to 0
-	RightElevatorMotor.Set(0);
-	LeftElevatorMotor.Set(0);
-
-
-//	RaiseElevator(consts::ElevatorIncrement::GROUND);
-	SmartDashboard::PutString("Auto Status", "Cube Dropped");
+	SettleDetector settleDetector(consts::ELEVATOR_PID_DEADBAND, consts::ELEVATOR_SETTLE_VELOCITY,
+			consts::SETTLE_DWELL_TIME_S, consts::STALL_TIME_S);
+
+	// The profile starts wherever the elevator is when the command starts, so it's planned then
+	auto startHeight = std::make_shared<double>(0);
+
+	return Named("Raise Elevator", std::make_unique<ProfileCommand>(
+		[this, elevatorHeight, startHeight]() {
+			*startHeight = ElevatorPID.GetHeightInches();
+			return MotionProfile(elevatorHeight - *startHeight, consts::ELEVATOR_MAX_VELOCITY,
+					consts::ELEVATOR_MAX_ACCELERATION, consts::ELEVATOR_MAX_JERK);
+		},
+		settleDetector,
+		[this, elevatorHeight, startHeight]() {
+			SmartDashboard::PutString("Auto Status", "Raising Elevator...");
+			// The gains are scheduled by the control executor from the height and direction
+			ElevatorPIDController.SetSetpoint(*startHeight);
+			ElevatorPIDController.Enable();
+		},
+		[this, elevatorHeight, startHeight](const MotionState& state) {
+			// The onboard loop plans its own Motion Magic profile, so it only needs the final height
+			double setpoint = consts::ELEVATOR_ONBOARD_LOOP ? elevatorHeight : *startHeight + state.position;
+			ElevatorPIDController.SetSetpoint(setpoint);
+			ElevatorPID.SetReference(state.velocity, state.acceleration);
+		},
+		// If the difference between heights isn't significant, the command finishes after the dwell time
+		[this, elevatorHeight]() { return elevatorHeight - ElevatorPID.GetHeightInches(); },
+		[this]() { return m_snapshot.elevatorVelocity; },
+		[this, elevatorHeight]() {
+			// Hold at the final setpoint with only the gravity feedforward
+			ElevatorPIDController.SetSetpoint(elevatorHeight);
+			ElevatorPID.SetReference(0, 0);
+			SmartDashboard::PutString("Auto Status", "Elevator Raised");
+		},
+		timeout));
 }
 
-void Robot::EjectCube(double intakeSpeed)
+// Keeps the intake pulling in so the cube doesn't slide out during a turn. This never
+// finishes on its own, so it's meant to be raced against another command
+AutoCommandPtr Robot::HoldCube()
 {
-	SmartDashboard::PutString("Auto Status", "Ejecting Cube...");
-	RightIntakeMotor.Set(-intakeSpeed);
-	LeftIntakeMotor.Set(intakeSpeed);
-	Wait(consts::INTAKE_WAIT_TIME);
-	LeftSolenoid.Set(DoubleSolenoid::Value::kReverse);
-	RightSolenoid.Set(DoubleSolenoid::Value::kReverse);
-	Wait(1.0 - consts::INTAKE_WAIT_TIME);
-	RightIntakeMotor.Set(0);
-	LeftIntakeMotor.Set(0);
-	SmartDashboard::PutString("Auto Status", "Ejected Cube");
-}
-
-void Robot::RaiseElevator(consts::ElevatorIncrement elevatorSetpoint, double timeout)
-{
-	double elevatorHeight = consts::ELEVATOR_SETPOINTS[elevatorSetpoint];
-
-	// If the difference between heights is significant, lift/lower the elevator
-	if(dabs(elevatorHeight - ElevatorPID.PIDGet()) > consts::ELEVATOR_PID_DEADBAND)
-	{
-		SmartDashboard::PutString("Auto Status", "Raising Elevator...");
-		RightElevatorMotor.Set(0);
-		ElevatorPIDController.SetSetpoint(elevatorHeight);
-		if(elevatorHeight > ElevatorPID.PIDGet())
-		{
-			ElevatorPIDController.SetPID(consts::ELEVATOR_PID_CONSTANTS_RISING[0],
-					consts::ELEVATOR_PID_CONSTANTS_RISING[1],
-					consts::ELEVATOR_PID_CONSTANTS_RISING[2]);
-		}
-		else
-		{
-			ElevatorPIDController.SetPID(consts::ELEVATOR_PID_CONSTANTS_LOWERING[0],
-					consts::ELEVATOR_PID_CONSTANTS_LOWERING[1],
-					consts::ELEVATOR_PID_CONSTANTS_LOWERING[2]);
-		}
-		ElevatorPIDController.Enable();
-
-		WaitUntilPIDSteady(ElevatorPIDController, ElevatorPID, timeout);
-		SmartDashboard::PutString("Auto Status", "Elevator Raised");
-	}
+	return Named("Hold Cube", std::make_unique<FunctionCommand>(
+		[this]() {
+			RightIntakeMotor.Set(consts::RESTING_INTAKE_SPEED);
+			LeftIntakeMotor.Set(-consts::RESTING_INTAKE_SPEED);
+		},
+		nullptr,
+		nullptr,
+		[this]() {
+			RightIntakeMotor.Set(0);
+			LeftIntakeMotor.Set(0);
+		}));
 }
 
 //Puts the power cube in either the same side scale or same switch switch
-void Robot::SidePath(consts::AutoPosition start, char switchPosition, char scalePosition)
+AutoCommandPtr Robot::SidePath(consts::AutoPosition start, consts::SwitchApproach approach, char switchPosition, char scalePosition)
 {
-	SmartDashboard::PutString("Auto Status", "Starting SidePath...");
+	auto path = std::make_unique<AutoSequence>();
+	path->SetName("Side Path");
+	path->Add(AutoStatus("Starting SidePath..."));
 	//90 for left, -90 for right
 	double angle = (start == consts::AutoPosition::LEFT_START) ? 90 : -90;
 	//L for left, R for right
 	char startPosition = (start == consts::AutoPosition::LEFT_START) ? 'L' : 'R';
 
 	// Get to middle of switch
-	DriveDistance(150);
+	path->Add(DriveDistance(150));
 
 	//Check if the switch is nearby, and if it is, place a cube in it
 	if(switchPosition == startPosition)
 	{
-		TurnAngle(angle);
-		DriveDistance(30, 2.75);
-		DropCube(consts::ElevatorIncrement::GROUND);
-		SmartDashboard::PutString("Auto Status", "Finished SidePath");
-		return; //End auto just in case the cube misses
+		path->Add(TurnAngle(angle));
+		path->Add(DriveDistance(30, 2.75));
+		path->Add(DropCube(consts::ElevatorIncrement::GROUND));
+		path->Add(AutoStatus("Finished SidePath"));
+		return std::move(path); //End auto just in case the cube misses
 	}
 
 	//Otherwise, go forward to a better position
-	DriveDistance(107);
+	path->Add(DriveDistance(107));
 
 	//Check if the scale is nearby, and if it is, place a cube in it
 	if(scalePosition == startPosition)
 	{
-		if(SwitchApproachChooser->GetSelected() == consts::SwitchApproach::SIDE)
+		// Raise the elevator while making the final approach to the scale
+		auto approachScale = std::make_unique<AutoSequence>();
+		if(approach == consts::SwitchApproach::SIDE)
 		{
-			DriveDistance(47);
-			TurnAngle(angle);
-			DriveDistance(6);
-
-//			DropCube(consts::ElevatorIncrement::SCALE_HIGH);
+			path->Add(DriveDistance(47));
+			approachScale->Add(TurnAngle(angle));
+			approachScale->Add(DriveDistance(6));
 		}
 		else
 		{
-			TurnAngle(angle / 2.0);
-			DriveDistance(10);
-
-//			DropCube(consts::ElevatorIncrement::SCALE_HIGH);
+			approachScale->Add(TurnAngle(angle / 2.0));
+			approachScale->Add(DriveDistance(10));
 		}
-		SmartDashboard::PutString("Auto Status", "Finished SidePath");
-		return; //End auto just in case the cube misses
+
+		auto raiseWhileApproaching = std::make_unique<ParallelGroup>();
+		raiseWhileApproaching->Add(std::move(approachScale));
+		raiseWhileApproaching->Add(RaiseElevator(consts::ElevatorIncrement::SCALE_HIGH));
+		path->Add(std::move(raiseWhileApproaching));
+
+		path->Add(DropCube(consts::ElevatorIncrement::SCALE_HIGH));
+		path->Add(AutoStatus("Finished SidePath"));
 	}
+	return std::move(path); //End auto just in case the cube misses
 }
 
 //Puts a power cube in the switch on the side opposite of the robot
-void Robot::OppositeSwitch(consts::AutoPosition start)
+AutoCommandPtr Robot::OppositeSwitch(consts::AutoPosition start, consts::SwitchApproach approach)
 {
-	SmartDashboard::PutString("Auto Status", "Starting OppositeSwitch...");
+	auto path = std::make_unique<AutoSequence>();
+	path->SetName("Opposite Switch");
+	path->Add(AutoStatus("Starting OppositeSwitch..."));
 	//90 for left, -90 for right
 	double angle = (start == consts::AutoPosition::LEFT_START) ? 90 : -90;
 
-	if(SwitchApproachChooser->GetSelected() == consts::SwitchApproach::FRONT)
+	if(approach == consts::SwitchApproach::FRONT)
 	{
 		// This path should never be selected because the
-//		DriveDistance(42.5);
-//		TurnAngle(angle);
+//		path->Add(DriveDistance(42.5));
+//		path->Add(TurnAngle(angle));
 //
-//		DriveDistance(155);
-//		TurnAngle(-angle);
+//		path->Add(DriveDistance(155));
+//		path->Add(TurnAngle(-angle));
 //
-//		TurnAngle(angle);
-//		DropCube(consts::ElevatorIncrement::GROUND);
+//		path->Add(TurnAngle(angle));
+//		path->Add(DropCube(consts::ElevatorIncrement::GROUND));
 	}
 	else
 	{
-		DriveDistance(215.4);
-		TurnAngle(angle);
+		path->Add(DriveDistance(215.4));
+		path->Add(TurnAngle(angle));
 
-		DriveDistance(171.5);
-		TurnAngle(angle);
+		path->Add(DriveDistance(171.5));
+		path->Add(TurnAngle(angle));
 
-		DriveDistance(10);
+		path->Add(DriveDistance(10));
 
 		//TENTATIVE, MIGHT NEED TO RAISE ELEVATOR
-		DropCube(consts::ElevatorIncrement::GROUND);
+		path->Add(DropCube(consts::ElevatorIncrement::GROUND));
 	}
-	SmartDashboard::PutString("Auto Status", "Finished OppositeSwitch");
+	path->Add(AutoStatus("Finished OppositeSwitch"));
+	return std::move(path);
 }
 
 //Puts a power cube in the scale on the side opposite of the robot
-void Robot::OppositeScale(consts::AutoPosition start)
+AutoCommandPtr Robot::OppositeScale(consts::AutoPosition start)
 {
-	SmartDashboard::PutString("Auto Status", "Starting OppositeScale...");
+	auto path = std::make_unique<AutoSequence>();
+	path->SetName("Opposite Scale");
+	path->Add(AutoStatus("Starting OppositeScale..."));
 	//90 for left, -90 for right
 	double angle = (start == consts::AutoPosition::LEFT_START) ? 90 : -90;
 	double secondAngle = (start == consts::AutoPosition::LEFT_START) ? -120 : 120;
 
-	DriveDistance(215.4);
-	TurnAngle(angle);
+	// Keep the cube pulled in while turning
+	auto firstTurn = std::make_unique<RaceGroup>();
+	firstTurn->Add(TurnAngle(angle));
+	firstTurn->Add(HoldCube());
+
+	auto secondTurn = std::make_unique<RaceGroup>();
+	secondTurn->Add(TurnAngle(secondAngle));
+	secondTurn->Add(HoldCube());
+
+	// Raise the elevator during the final drive to the scale. DriveDistance slows
+	// itself down once the elevator gets too high
+	auto raiseWhileDriving = std::make_unique<ParallelGroup>();
+	raiseWhileDriving->Add(DriveDistance(55.25));
+	raiseWhileDriving->Add(RaiseElevator(consts::ElevatorIncrement::SCALE_HIGH));
+
+	path->Add(DriveDistance(215.4));
+	path->Add(std::move(firstTurn));
 
-	DriveDistance(245);
-	TurnAngle(secondAngle);
+	path->Add(DriveDistance(245));
+	path->Add(std::move(secondTurn));
 
-	DriveDistance(55.25);
+	path->Add(std::move(raiseWhileDriving));
 
-	DropCube(consts::ElevatorIncrement::SCALE_HIGH);
-	SmartDashboard::PutString("Auto Status", "Finished OppositeScale");
+	path->Add(DropCube(consts::ElevatorIncrement::SCALE_HIGH));
+	path->Add(AutoStatus("Finished OppositeScale"));
+	return std::move(path);
 }
 
 //Puts a power cube in the switch from the middle position
-void Robot::MiddlePath(char switchPosition)
+AutoCommandPtr Robot::MiddlePath(char switchPosition)
 {
-	SmartDashboard::PutString("Auto Status", "Starting MiddlePath...");
+	auto path = std::make_unique<AutoSequence>();
+	path->SetName("Middle Path");
+	path->Add(AutoStatus("Starting MiddlePath..."));
 	double angle = 90;
 
 	//Go forward
-	DriveDistance(48);
+	path->Add(DriveDistance(48));
 
 	//Check which way the cube should be placed (NOW DEPRECATED)
 //	if(SwitchApproachChooser->GetSelected() == consts::SwitchApproach::SIDE)
@@ -482,49 +681,50 @@ void Robot::MiddlePath(char switchPosition)
 //		//If the cube is being placed from the side
 //		if(switchPosition == 'L')
 //		{
-//			TurnAngle(-angle);
-//			DriveDistance(126);
+//			path->Add(TurnAngle(-angle));
+//			path->Add(DriveDistance(126));
 //
-//			TurnAngle(angle);
-//			DriveDistance(106);
+//			path->Add(TurnAngle(angle));
+//			path->Add(DriveDistance(106));
 //
-//			TurnAngle(angle);
-//			DropCube(consts::ElevatorIncrement::GROUND);
+//			path->Add(TurnAngle(angle));
+//			path->Add(DropCube(consts::ElevatorIncrement::GROUND));
 //		}
 //		else if(switchPosition == 'R')
 //		{
-//			TurnAngle(angle);
-//			DriveDistance(74);
+//			path->Add(TurnAngle(angle));
+//			path->Add(DriveDistance(74));
 //
-//			TurnAngle(-angle);
-//			DriveDistance(106);
+//			path->Add(TurnAngle(-angle));
+//			path->Add(DriveDistance(106));
 //
-//			TurnAngle(angle);
+//			path->Add(TurnAngle(angle));
 //
-//			DropCube(consts::ElevatorIncrement::GROUND);
+//			path->Add(DropCube(consts::ElevatorIncrement::GROUND));
 //		}
 //	}
 
 	// The cube is always placed from the front.
 	if(switchPosition == 'L')
 	{
-		TurnAngle(-angle);
-		DriveDistance(52);
+		path->Add(TurnAngle(-angle));
+		path->Add(DriveDistance(52));
 
-		TurnAngle(angle);
-		DriveDistance(64, 2.75);
+		path->Add(TurnAngle(angle));
+		path->Add(DriveDistance(64, 2.75));
 
-		DropCube(consts::ElevatorIncrement::GROUND);
+		path->Add(DropCube(consts::ElevatorIncrement::GROUND));
 	}
 	else if(switchPosition == 'R')
 	{
-		TurnAngle(angle);
-		DriveDistance(52);
+		path->Add(TurnAngle(angle));
+		path->Add(DriveDistance(52));
 
-		TurnAngle(-angle);
-		DriveDistance(64, 2.75);
+		path->Add(TurnAngle(-angle));
+		path->Add(DriveDistance(64, 2.75));
 
-		DropCube(consts::ElevatorIncrement::GROUND);
+		path->Add(DropCube(consts::ElevatorIncrement::GROUND));
 	}
-	SmartDashboard::PutString("Auto Status", "Finished MiddlePath");
+	path->Add(AutoStatus("Finished MiddlePath"));
+	return std::move(path);
 }
@@ -0,0 +1,156 @@
+#include "AutoCommand.h"
+#include "../Diagnostics/Tracer.h"
+
+AutoCommand::AutoCommand(double timeout) :
+	m_timer(),
+	m_timeout(timeout),
+	m_isRunning(false),
+	m_name(),
+	m_traceStartMicros(0)
+{
+
+}
+
+AutoCommand::~AutoCommand()
+{
+
+}
+
+bool AutoCommand::Run()
+{
+	if(!m_isRunning)
+	{
+		m_isRunning = true;
+		m_timer.Reset();
+		m_timer.Start();
+		m_traceStartMicros = Tracer::GetMicros();
+		Initialize();
+	}
+
+	Execute();
+
+	if(IsFinished() || IsTimedOut())
+	{
+		End(false);
+		m_timer.Stop();
+		m_isRunning = false;
+		Trace();
+		return true;
+	}
+	return false;
+}
+
+void AutoCommand::Cancel()
+{
+	if(m_isRunning)
+	{
+		End(true);
+		m_timer.Stop();
+		m_isRunning = false;
+		Trace();
+	}
+}
+
+bool AutoCommand::IsRunning()
+{
+	return m_isRunning;
+}
+
+bool AutoCommand::IsTimedOut()
+{
+	return m_timeout >= 0 && m_timer.Get() >= m_timeout;
+}
+
+double AutoCommand::GetElapsedTime()
+{
+	return m_timer.Get();
+}
+
+void AutoCommand::SetName(std::string name)
+{
+	m_name = name;
+}
+
+const std::string& AutoCommand::GetName()
+{
+	return m_name;
+}
+
+void AutoCommand::Trace()
+{
+	if(!m_name.empty()) Tracer::GetInstance().AddSpan(m_name.c_str(), "auto", m_traceStartMicros, Tracer::GetMicros());
+}
+
+FunctionCommand::FunctionCommand(std::function<void()> initialize, std::function<void()> execute,
+		std::function<bool()> isFinished, std::function<void()> end, double timeout) :
+	AutoCommand(timeout),
+	m_initialize(initialize),
+	m_execute(execute),
+	m_isFinished(isFinished),
+	m_end(end)
+{
+
+}
+
+FunctionCommand::~FunctionCommand()
+{
+
+}
+
+void FunctionCommand::Initialize()
+{
+	if(m_initialize) m_initialize();
+}
+
+void FunctionCommand::Execute()
+{
+	if(m_execute) m_execute();
+}
+
+bool FunctionCommand::IsFinished()
+{
+	// Commands without a finish condition only end when they time out
+	return m_isFinished ? m_isFinished() : false;
+}
+
+void FunctionCommand::End(bool interrupted)
+{
+	if(m_end) m_end();
+}
+
+InstantCommand::InstantCommand(std::function<void()> action) :
+	m_action(action)
+{
+
+}
+
+InstantCommand::~InstantCommand()
+{
+
+}
+
+void InstantCommand::Initialize()
+{
+	if(m_action) m_action();
+}
+
+bool InstantCommand::IsFinished()
+{
+	return true;
+}
+
+WaitCommand::WaitCommand(double seconds) :
+	AutoCommand(seconds)
+{
+
+}
+
+WaitCommand::~WaitCommand()
+{
+
+}
+
+bool WaitCommand::IsFinished()
+{
+	return false;
+}
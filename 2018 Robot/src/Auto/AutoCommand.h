@@ -0,0 +1,105 @@
+#ifndef AUTO_COMMAND
+#define AUTO_COMMAND
+
+#include <WPILib.h>
+#include <functional>
+#include <memory>
+#include <string>
+
+using namespace frc;
+
+// A single resumable step of an autonomous routine. Run() is called once per robot
+// loop: the first call initializes the command, and every call executes it and checks
+// whether it has finished or timed out, so nothing ever blocks the main robot thread.
+// A named command adds a span from its start to its end to the trace
+class AutoCommand
+{
+private:
+	Timer m_timer;
+	double m_timeout;   // A negative timeout means the command never times out
+	bool m_isRunning;
+	std::string m_name;
+	int64_t m_traceStartMicros;
+
+	void Trace();
+
+protected:
+	virtual void Initialize() {}
+	virtual void Execute() {}
+	virtual bool IsFinished() = 0;
+	virtual void End(bool interrupted) {}
+
+public:
+	AutoCommand(double timeout = -1);
+	virtual ~AutoCommand();
+
+	// Runs one tick of the command. Returns true once the command has ended
+	bool Run();
+	void Cancel();
+
+	bool IsRunning();
+	bool IsTimedOut();
+	double GetElapsedTime();
+
+	void SetName(std::string name);
+	const std::string& GetName();
+};
+
+typedef std::unique_ptr<AutoCommand> AutoCommandPtr;
+
+// Names a command where it's built, e.g. return Named("Drive Distance", std::make_unique<...>(...));
+inline AutoCommandPtr Named(std::string name, AutoCommandPtr command)
+{
+	command->SetName(name);
+	return command;
+}
+
+// Builds a command out of callbacks so that the robot can describe its auto steps
+// without a new class for every one of them
+class FunctionCommand : public AutoCommand
+{
+private:
+	std::function<void()> m_initialize;
+	std::function<void()> m_execute;
+	std::function<bool()> m_isFinished;
+	std::function<void()> m_end;
+
+protected:
+	void Initialize() override;
+	void Execute() override;
+	bool IsFinished() override;
+	void End(bool interrupted) override;
+
+public:
+	FunctionCommand(std::function<void()> initialize, std::function<void()> execute,
+			std::function<bool()> isFinished, std::function<void()> end, double timeout = -1);
+	virtual ~FunctionCommand();
+};
+
+// Runs a callback once and finishes in the same tick
+class InstantCommand : public AutoCommand
+{
+private:
+	std::function<void()> m_action;
+
+protected:
+	void Initialize() override;
+	bool IsFinished() override;
+
+public:
+	InstantCommand(std::function<void()> action);
+	virtual ~InstantCommand();
+};
+
+// Finishes after a given number of seconds without touching any hardware
+class WaitCommand : public AutoCommand
+{
+protected:
+	bool IsFinished() override;
+
+public:
+	WaitCommand(double seconds);
+	virtual ~WaitCommand();
+};
+
+#endif
@@ -0,0 +1,49 @@
+#include "AutoScheduler.h"
+
+AutoScheduler::AutoScheduler() :
+	m_routine(nullptr)
+{
+
+}
+
+AutoScheduler::~AutoScheduler()
+{
+
+}
+
+void AutoScheduler::Start(AutoCommandPtr routine)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	CancelRoutine();
+	m_routine = std::move(routine);
+}
+
+void AutoScheduler::Run()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if(m_routine && m_routine->Run())
+	{
+		m_routine.reset();
+	}
+}
+
+void AutoScheduler::Cancel()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	CancelRoutine();
+}
+
+void AutoScheduler::CancelRoutine()
+{
+	if(m_routine)
+	{
+		m_routine->Cancel();
+		m_routine.reset();
+	}
+}
+
+bool AutoScheduler::IsRunning()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_routine != nullptr;
+}
@@ -0,0 +1,27 @@
+#ifndef AUTO_SCHEDULER
+#define AUTO_SCHEDULER
+
+#include <mutex>
+#include "AutoCommand.h"
+
+// Owns the currently running auto routine and ticks it once per robot loop. The routine
+// can also be started and ticked from the GameDataListener thread, so every call is locked
+class AutoScheduler
+{
+private:
+	AutoCommandPtr m_routine;
+	std::mutex m_mutex;
+
+	void CancelRoutine();
+
+public:
+	AutoScheduler();
+	virtual ~AutoScheduler();
+
+	void Start(AutoCommandPtr routine);
+	void Run();
+	void Cancel();
+	bool IsRunning();
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include "CommandGroups.h"
+
+AutoSequence::AutoSequence() :
+	m_commands(),
+	m_currentCommand(0)
+{
+
+}
+
+AutoSequence::~AutoSequence()
+{
+
+}
+
+void AutoSequence::Add(AutoCommandPtr command)
+{
+	m_commands.push_back(std::move(command));
+}
+
+void AutoSequence::Initialize()
+{
+	m_currentCommand = 0;
+}
+
+void AutoSequence::Execute()
+{
+	while(m_currentCommand < m_commands.size() && m_commands[m_currentCommand]->Run())
+	{
+		m_currentCommand++;
+	}
+}
+
+bool AutoSequence::IsFinished()
+{
+	return m_currentCommand >= m_commands.size();
+}
+
+void AutoSequence::End(bool interrupted)
+{
+	if(interrupted && m_currentCommand < m_commands.size())
+	{
+		m_commands[m_currentCommand]->Cancel();
+	}
+}
+
+ParallelGroup::ParallelGroup() :
+	m_commands(),
+	m_isCommandFinished()
+{
+
+}
+
+ParallelGroup::~ParallelGroup()
+{
+
+}
+
+void ParallelGroup::Add(AutoCommandPtr command)
+{
+	m_commands.push_back(std::move(command));
+	m_isCommandFinished.push_back(false);
+}
+
+void ParallelGroup::Initialize()
+{
+	for(unsigned int i = 0; i < m_isCommandFinished.size(); i++)
+	{
+		m_isCommandFinished[i] = false;
+	}
+}
+
+void ParallelGroup::Execute()
+{
+	for(unsigned int i = 0; i < m_commands.size(); i++)
+	{
+		if(!m_isCommandFinished[i])
+		{
+			m_isCommandFinished[i] = m_commands[i]->Run();
+		}
+	}
+}
+
+bool ParallelGroup::IsFinished()
+{
+	for(unsigned int i = 0; i < m_isCommandFinished.size(); i++)
+	{
+		if(!m_isCommandFinished[i]) return false;
+	}
+	return true;
+}
+
+void ParallelGroup::End(bool interrupted)
+{
+	// Stop anything that is still running, either because the group was cancelled
+	// or because a RaceGroup was won by another command
+	for(unsigned int i = 0; i < m_commands.size(); i++)
+	{
+		if(!m_isCommandFinished[i])
+		{
+			m_commands[i]->Cancel();
+		}
+	}
+}
+
+RaceGroup::RaceGroup() :
+	ParallelGroup()
+{
+
+}
+
+RaceGroup::~RaceGroup()
+{
+
+}
+
+bool RaceGroup::IsFinished()
+{
+	for(unsigned int i = 0; i < m_isCommandFinished.size(); i++)
+	{
+		if(m_isCommandFinished[i]) return true;
+	}
+	return m_commands.empty();
+}
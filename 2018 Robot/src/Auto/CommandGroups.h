@@ -0,0 +1,60 @@
+#ifndef COMMAND_GROUPS
+#define COMMAND_GROUPS
+
+#include <vector>
+#include "AutoCommand.h"
+
+// Runs its commands one after another. When a command finishes, the next one is
+// started in the same tick so that no robot loop is wasted between auto steps
+class AutoSequence : public AutoCommand
+{
+private:
+	std::vector<AutoCommandPtr> m_commands;
+	unsigned int m_currentCommand;
+
+protected:
+	void Initialize() override;
+	void Execute() override;
+	bool IsFinished() override;
+	void End(bool interrupted) override;
+
+public:
+	AutoSequence();
+	virtual ~AutoSequence();
+
+	void Add(AutoCommandPtr command);
+};
+
+// Runs all of its commands at the same time and finishes once every one of them has.
+// The commands must not use the same motors or controllers
+class ParallelGroup : public AutoCommand
+{
+protected:
+	std::vector<AutoCommandPtr> m_commands;
+	std::vector<bool> m_isCommandFinished;
+
+	void Initialize() override;
+	void Execute() override;
+	bool IsFinished() override;
+	void End(bool interrupted) override;
+
+public:
+	ParallelGroup();
+	virtual ~ParallelGroup();
+
+	void Add(AutoCommandPtr command);
+};
+
+// Runs all of its commands at the same time and finishes as soon as any one of them
+// does, cancelling the rest
+class RaceGroup : public ParallelGroup
+{
+protected:
+	bool IsFinished() override;
+
+public:
+	RaceGroup();
+	virtual ~RaceGroup();
+};
+
+#endif
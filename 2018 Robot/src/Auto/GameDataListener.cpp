@@ -0,0 +1,65 @@
+#include "GameDataListener.h"
+#include "../Diagnostics/Tracer.h"
+
+GameDataListener::GameDataListener(std::function<void(std::string)> onGameData,
+		std::function<bool(double)> waitForData, std::function<std::string()> getGameData) :
+	m_onGameData(onGameData),
+	m_waitForData(waitForData),
+	m_getGameData(getGameData),
+	m_thread(),
+	m_isRunning(false),
+	m_isArmed(false)
+{
+
+}
+
+GameDataListener::~GameDataListener()
+{
+	Stop();
+}
+
+void GameDataListener::Start()
+{
+	if(m_isRunning) return;
+
+	m_isRunning = true;
+	m_thread = std::thread(&GameDataListener::Listen, this);
+}
+
+void GameDataListener::Stop()
+{
+	m_isRunning = false;
+	m_isArmed = false;
+	if(m_thread.joinable())
+	{
+		m_thread.join();
+	}
+}
+
+void GameDataListener::Arm()
+{
+	m_isArmed = true;
+}
+
+void GameDataListener::Disarm()
+{
+	m_isArmed = false;
+}
+
+void GameDataListener::Listen()
+{
+	Tracer::GetInstance().SetThreadName("Game Data");
+	while(m_isRunning)
+	{
+		// Wake up on every new driver station packet, but time out every so often
+		// so the thread can be stopped
+		if(!m_waitForData(0.1) || !m_isArmed) continue;
+
+		std::string gameData = m_getGameData();
+		if(gameData.length() > 0 && m_isArmed.exchange(false))
+		{
+			ScopedTraceSpan span("Game Data", "auto");
+			m_onGameData(gameData);
+		}
+	}
+}
@@ -0,0 +1,41 @@
+#ifndef GAME_DATA_LISTENER
+#define GAME_DATA_LISTENER
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+// Waits on the driver station's new data event in a background thread and calls
+// onGameData as soon as the packet carrying the game specific message has been
+// processed, instead of polling for the message from the main robot loop.
+// - The driver station is reached through waitForData and getGameData, so a stand-in can
+//   drive the listener in host tests. waitForData blocks until the next packet or until the
+//   timeout in seconds passes, and returns false on a timeout
+class GameDataListener
+{
+private:
+	std::function<void(std::string)> m_onGameData;
+	std::function<bool(double)> m_waitForData;
+	std::function<std::string()> m_getGameData;
+	std::thread m_thread;
+	std::atomic<bool> m_isRunning;
+	std::atomic<bool> m_isArmed;
+
+	void Listen();
+
+public:
+	GameDataListener(std::function<void(std::string)> onGameData,
+			std::function<bool(double)> waitForData, std::function<std::string()> getGameData);
+	virtual ~GameDataListener();
+
+	void Start();
+	// Waits for the thread to finish, including a call to onGameData that's in progress
+	void Stop();
+
+	// Only an armed listener reports the game data, and it disarms itself after reporting it once
+	void Arm();
+	void Disarm();
+};
+
+#endif
@@ -0,0 +1,43 @@
+#include "ProfileCommand.h"
+
+ProfileCommand::ProfileCommand(MotionProfile profile, SettleDetector settleDetector, std::function<void()> initialize,
+		std::function<void(const MotionState&)> followState, std::function<double()> getError,
+		std::function<double()> getVelocity, std::function<void()> end, double timeout) :
+	ProfileCommand([profile]() { return profile; }, settleDetector, initialize, followState,
+			getError, getVelocity, end, timeout)
+{
+
+}
+
+ProfileCommand::ProfileCommand(std::function<MotionProfile()> planProfile, SettleDetector settleDetector,
+		std::function<void()> initialize, std::function<void(const MotionState&)> followState,
+		std::function<double()> getError, std::function<double()> getVelocity,
+		std::function<void()> end, double timeout) :
+	SettleCommand(settleDetector, initialize, getError, getVelocity, end, timeout),
+	m_planProfile(planProfile),
+	m_profile(0, 0, 0),
+	m_followState(followState)
+{
+
+}
+
+ProfileCommand::~ProfileCommand()
+{
+
+}
+
+void ProfileCommand::Initialize()
+{
+	m_profile = m_planProfile();
+	SettleCommand::Initialize();
+}
+
+void ProfileCommand::Execute()
+{
+	m_followState(m_profile.Sample(GetElapsedTime()));
+}
+
+bool ProfileCommand::IsReadyToSettle()
+{
+	return GetElapsedTime() >= m_profile.GetDuration();
+}
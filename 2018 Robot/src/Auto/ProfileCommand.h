@@ -0,0 +1,35 @@
+#ifndef PROFILE_COMMAND
+#define PROFILE_COMMAND
+
+#include "SettleCommand.h"
+#include "../PID/MotionProfile.h"
+
+// Walks a control loop along a motion profile. Every tick the profile is sampled at the
+// time since the command started and the sample is handed to followState, which moves the
+// setpoint and sets the feedforward. The command can only settle once the profile is over
+// - Moves that depend on where the mechanism is when the command starts can pass planProfile
+//   instead of a profile, which is called once from Initialize()
+class ProfileCommand : public SettleCommand
+{
+private:
+	std::function<MotionProfile()> m_planProfile;
+	MotionProfile m_profile;
+	std::function<void(const MotionState&)> m_followState;
+
+protected:
+	void Initialize() override;
+	void Execute() override;
+	bool IsReadyToSettle() override;
+
+public:
+	ProfileCommand(MotionProfile profile, SettleDetector settleDetector, std::function<void()> initialize,
+			std::function<void(const MotionState&)> followState, std::function<double()> getError,
+			std::function<double()> getVelocity, std::function<void()> end, double timeout);
+	ProfileCommand(std::function<MotionProfile()> planProfile, SettleDetector settleDetector,
+			std::function<void()> initialize, std::function<void(const MotionState&)> followState,
+			std::function<double()> getError, std::function<double()> getVelocity,
+			std::function<void()> end, double timeout);
+	virtual ~ProfileCommand();
+};
+
+#endif
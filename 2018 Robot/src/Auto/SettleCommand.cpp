@@ -0,0 +1,78 @@
+#include "SettleCommand.h"
+#include "../Diagnostics/Tracer.h"
+
+SettleCommand::SettleCommand(SettleDetector settleDetector, std::function<void()> initialize,
+		std::function<double()> getError, std::function<double()> getVelocity,
+		std::function<void()> end, double timeout) :
+	AutoCommand(timeout),
+	m_settleDetector(settleDetector),
+	m_initialize(initialize),
+	m_getError(getError),
+	m_getVelocity(getVelocity),
+	m_end(end),
+	m_prevTime(0),
+	m_result(SegmentResult::IN_PROGRESS),
+	m_settleStartMicros(0)
+{
+
+}
+
+SettleCommand::~SettleCommand()
+{
+
+}
+
+void SettleCommand::Initialize()
+{
+	m_settleDetector.Reset();
+	m_prevTime = 0;
+	m_result = SegmentResult::IN_PROGRESS;
+	m_settleStartMicros = 0;
+	if(m_initialize) m_initialize();
+}
+
+bool SettleCommand::IsReadyToSettle()
+{
+	return true;
+}
+
+bool SettleCommand::IsFinished()
+{
+	double time = GetElapsedTime();
+	double dt = time - m_prevTime;
+	m_prevTime = time;
+
+	if(!IsReadyToSettle())
+	{
+		m_settleDetector.Reset();
+		return false;
+	}
+
+	if(m_settleStartMicros == 0) m_settleStartMicros = Tracer::GetMicros();
+	m_settleDetector.Update(m_getError(), m_getVelocity(), dt);
+	return m_settleDetector.IsSettled() || m_settleDetector.IsStalled();
+}
+
+void SettleCommand::End(bool interrupted)
+{
+	if(interrupted)                          m_result = SegmentResult::CANCELLED;
+	else if(m_settleDetector.IsSettled())    m_result = SegmentResult::SETTLED;
+	else if(m_settleDetector.IsStalled())    m_result = SegmentResult::STALLED;
+	else                                     m_result = SegmentResult::TIMED_OUT;
+
+	SmartDashboard::PutString("Segment Result", SegmentResultName(m_result));
+	SmartDashboard::PutNumber("Segment Time", GetElapsedTime());
+
+	// The wait for the loop to settle shows up inside the command's own span
+	if(m_settleStartMicros != 0)
+	{
+		Tracer::GetInstance().AddSpan(SegmentResultName(m_result), "settle", m_settleStartMicros, Tracer::GetMicros());
+	}
+
+	if(m_end) m_end();
+}
+
+SegmentResult SettleCommand::GetResult()
+{
+	return m_result;
+}
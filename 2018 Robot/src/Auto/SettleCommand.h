@@ -0,0 +1,39 @@
+#ifndef SETTLE_COMMAND
+#define SETTLE_COMMAND
+
+#include "AutoCommand.h"
+#include "../PID/SettleDetector.h"
+
+// Runs a closed loop segment until its SettleDetector says it has settled or stalled, or until
+// the timeout passes. The reason the segment ended is published to the dashboard along with
+// how long it took
+class SettleCommand : public AutoCommand
+{
+private:
+	SettleDetector m_settleDetector;
+	std::function<void()> m_initialize;
+	std::function<double()> m_getError;
+	std::function<double()> m_getVelocity;
+	std::function<void()> m_end;
+	double m_prevTime;
+	SegmentResult m_result;
+	int64_t m_settleStartMicros;   // When the command started waiting to settle, or 0 if it hasn't
+
+protected:
+	void Initialize() override;
+	bool IsFinished() override;
+	void End(bool interrupted) override;
+
+	// Lets subclasses hold off on settling, e.g. while a motion profile is still running
+	virtual bool IsReadyToSettle();
+
+public:
+	SettleCommand(SettleDetector settleDetector, std::function<void()> initialize,
+			std::function<double()> getError, std::function<double()> getVelocity,
+			std::function<void()> end, double timeout);
+	virtual ~SettleCommand();
+
+	SegmentResult GetResult();
+};
+
+#endif
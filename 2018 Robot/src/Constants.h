@@ -1,11 +1,52 @@
 #ifndef CONSTANTS
 #define CONSTANTS
 
+#include "Units.h"
+
 namespace consts
 {
+	using namespace units::literals;
+
 	// Auto Constants
 	constexpr double GAME_DATA_TIMEOUT_S = 1;
 	constexpr double PID_TIMEOUT_S = 5;
+	constexpr int NUM_FIELD_LAYOUTS = 4; // LL, LR, RL and RR switch/scale plate assignments
+
+	// Settle detection constants
+	// - A segment ends once it has been on target and stopped for the dwell time,
+	//   or once it has stopped short of the target for the stall time
+	constexpr double SETTLE_DWELL_TIME_S = 0.1;
+	constexpr double STALL_TIME_S = 0.5;
+	constexpr double DRIVE_SETTLE_TOLERANCE = 3.5;  // Inches
+	constexpr double DRIVE_SETTLE_VELOCITY = 4;     // Inches per second
+	constexpr double TURN_SETTLE_TOLERANCE = 1;     // Degrees
+	constexpr double TURN_SETTLE_VELOCITY = 5;      // Degrees per second
+	constexpr double ELEVATOR_SETTLE_VELOCITY = 3;  // Inches per second
+
+	// Motion profile limits and feedforward gains (NEEDS TUNING)
+	// - Drive values are in inches, turn values are in degrees
+	constexpr double DRIVE_MAX_VELOCITY = 120;
+	constexpr double DRIVE_MAX_ACCELERATION = 150;
+	constexpr double DRIVE_MAX_JERK = 900;
+	constexpr double DRIVE_KV = 1. / 160.;   // Motor output per inch per second
+	constexpr double DRIVE_KA = 0.002;       // Motor output per inch per second squared
+
+	constexpr double TURN_MAX_VELOCITY = 180;
+	constexpr double TURN_MAX_ACCELERATION = 360;
+	constexpr double TURN_MAX_JERK = 1800;
+	constexpr double TURN_KV = 1. / 600.;
+	constexpr double TURN_KA = 0.0003;
+
+	// Velocity estimator constants (NEEDS TUNING)
+	// - The alpha is how much of each new encoder reading is trusted over the prediction
+	// - The Talon's own velocity is blended in by the measured velocity weight
+	// - Readings that jump faster than the max velocity (e.g. the encoder was zeroed) or come
+	//   more than the max sample period apart restart the estimate
+	constexpr double VELOCITY_ESTIMATOR_ALPHA = 0.5;
+	constexpr double MEASURED_VELOCITY_WEIGHT = 0.1;
+	constexpr double VELOCITY_ESTIMATOR_MAX_SAMPLE_PERIOD_S = 0.1;
+	constexpr double DRIVE_MAX_SENSOR_VELOCITY = 200;      // Inches per second
+	constexpr double ELEVATOR_MAX_SENSOR_VELOCITY = 100;   // Inches per second
 
 	// Auto Sendable Chooser enums
 	enum class AutoPosition
@@ -42,22 +83,113 @@ namespace consts
 	};
 
 	constexpr double DRIVE_SPEED_REDUCTION = 5. / 8.;
+	constexpr double DISTANCE_PID_MAX_OUTPUT = 0.7;
 
 	// Elevator Constants
 	constexpr int NUM_ELEVATOR_SETPOINTS = 5;
 	constexpr double ELEVATOR_SETPOINTS[NUM_ELEVATOR_SETPOINTS] = {0, 20, 40, 60, 100};
-	constexpr double ELEVATOR_INCREMENT_PER_CYCLE = 35. / 20.; // 35" per second
+	constexpr units::InchesPerSecond ELEVATOR_MANUAL_SPEED = 87.5_in / 1_s;  // 1.75" per 20ms robot loop
 	constexpr double ELEVATOR_SPEED_REDUCTION = 1. / 3.;
 	constexpr int ELEVATOR_CONT_CURRENT_MAX = 60;
 	constexpr int ELEVATOR_CONT_CURRENT_TIMEOUT_MS = 2000;
 
 	constexpr double ELEVATOR_PID_DEADBAND = 2.0;
-	constexpr double ELEVATOR_PID_CONSTANTS_RISING[] = {0.25, 0., 0.};
-	constexpr double ELEVATOR_PID_CONSTANTS_LOWERING[] = {0.25, 0., 0.};
+
+	// Elevator gain schedule (NEEDS TUNING)
+	// - Each row holds the gains at one height, and the gains in between heights are interpolated
+	// - Because this is an enum and not an enum class, you can use the enum value
+	//   as an index into a row
+	// - KG holds the carriage against gravity, so the PID only has to correct the remaining error
+	// - KS is the output needed to overcome friction once the carriage starts moving
+	// - KV is in motor output per inch per second and KA in motor output per inch per second squared
+	// - The middle of the travel is stiffer so moves up to SCALE_HIGH get there faster, while the
+	//   rows next to the hard stops keep a gentle P like the safety mode in CapElevatorOutput()
+	enum ElevatorGain
+	{
+		ELEVATOR_P,
+		ELEVATOR_I,
+		ELEVATOR_D,
+		ELEVATOR_KG,
+		ELEVATOR_KS,
+		ELEVATOR_KV,
+		ELEVATOR_KA,
+		NUM_ELEVATOR_GAINS
+	};
+
+	constexpr int NUM_ELEVATOR_GAIN_HEIGHTS = 5;
+	constexpr double ELEVATOR_GAIN_HEIGHTS[NUM_ELEVATOR_GAIN_HEIGHTS] = {0, 12.5, 40, 80, 100};
+	constexpr double ELEVATOR_GAINS_RISING[NUM_ELEVATOR_GAIN_HEIGHTS][NUM_ELEVATOR_GAINS] = {
+	//	 P      I    D      KG     KS     KV         KA
+		{0.15,  0.,  0.,    0.10,  0.05,  1. / 60.,  0.002},
+		{0.35,  0.,  0.02,  0.11,  0.05,  1. / 60.,  0.002},
+		{0.40,  0.,  0.02,  0.12,  0.05,  1. / 60.,  0.002},
+		{0.35,  0.,  0.02,  0.13,  0.05,  1. / 60.,  0.002},
+		{0.15,  0.,  0.,    0.13,  0.05,  1. / 60.,  0.002}
+	};
+	constexpr double ELEVATOR_GAINS_LOWERING[NUM_ELEVATOR_GAIN_HEIGHTS][NUM_ELEVATOR_GAINS] = {
+	//	 P      I    D      KG     KS     KV         KA
+		{0.10,  0.,  0.,    0.10,  0.04,  1. / 70.,  0.002},
+		{0.25,  0.,  0.02,  0.11,  0.04,  1. / 70.,  0.002},
+		{0.30,  0.,  0.02,  0.12,  0.04,  1. / 70.,  0.002},
+		{0.25,  0.,  0.02,  0.13,  0.04,  1. / 70.,  0.002},
+		{0.15,  0.,  0.,    0.13,  0.04,  1. / 70.,  0.002}
+	};
+
+	// Elevator motion profile constants (NEEDS TUNING)
+	constexpr double ELEVATOR_MAX_VELOCITY = 45;
+	constexpr double ELEVATOR_MAX_ACCELERATION = 90;
+	constexpr double ELEVATOR_MAX_JERK = 600;
+
+	// Onboard elevator loop constants (NEEDS TUNING)
+	// - When ELEVATOR_ONBOARD_LOOP is true, the elevator ControlLoop hands its setpoint to the right
+	//   elevator Talon's Motion Magic controller instead of running the PID on the roboRIO
+	constexpr bool ELEVATOR_ONBOARD_LOOP = false;
+	constexpr double ELEVATOR_ONBOARD_P = 0.3;
+	constexpr double ELEVATOR_ONBOARD_D = 0.;
+
+	// Relay autotune constants for Test mode
+	// - The relay amplitude is the motor output that is switched on and off around the setpoint,
+	//   and the hysteresis keeps sensor noise from switching it early
+	// - The settle times are what the proposed gains aim for
+	constexpr int AUTOTUNE_CYCLES = 5;
+	constexpr double AUTOTUNE_TIMEOUT_S = 15;
+	constexpr double AUTOTUNE_TURN_AMPLITUDE = 0.3;
+	constexpr double AUTOTUNE_TURN_HYSTERESIS = 0.5;      // Degrees
+	constexpr double AUTOTUNE_TURN_SETTLE_TIME = 0.6;
+	constexpr double AUTOTUNE_DRIVE_AMPLITUDE = 0.3;
+	constexpr double AUTOTUNE_DRIVE_HYSTERESIS = 0.5;     // Inches
+	constexpr double AUTOTUNE_DRIVE_SETTLE_TIME = 0.8;
+	constexpr double AUTOTUNE_ELEVATOR_AMPLITUDE = 0.15;
+	constexpr double AUTOTUNE_ELEVATOR_HYSTERESIS = 0.5;  // Inches
+	constexpr double AUTOTUNE_ELEVATOR_SETTLE_TIME = 0.6;
+
+	// Heading fusion constants (NEEDS TUNING)
+	// - The fusion gain is how much of the NavX/ADXRS450 disagreement is corrected every sample,
+	//   which at 200Hz gives a time constant of about a quarter of a second
+	// - The bias gain is how fast the ADXRS450 bias estimate follows that disagreement
+	constexpr int NAVX_UPDATE_RATE_HZ = 200;
+	constexpr double ANGLE_FUSION_GAIN = 0.02;
+	constexpr units::PerSecond GYRO_BIAS_GAIN(0.001);   // Degrees per second per degree of disagreement, every sample
 
 	// Talon configuration constants
 	constexpr int PID_LOOP_ID = 0;
 	constexpr int TALON_TIMEOUT_MS = 10;
+	constexpr int MOTION_MAGIC_SLOT = 0;
+
+	// CAN bus constants
+	// - Status frame periods are in ms. The Talon can't send a frame slower than every 255ms
+	// - The other frames are the PDP and PCM, which aren't managed by the CanBandwidthManager (NEEDS CHECKING)
+	constexpr int CAN_ACTIVE_FEEDBACK_PERIOD_MS = 5;    // Encoder feedback while its loop is running
+	constexpr int CAN_FEEDBACK_PERIOD_MS = 10;
+	constexpr int CAN_CURRENT_PERIOD_MS = 50;
+	constexpr int CAN_GENERAL_PERIOD_MS = 10;
+	constexpr int CAN_SLOW_GENERAL_PERIOD_MS = 20;
+	constexpr int CAN_ONBOARD_LOOP_PERIOD_MS = 20;
+	constexpr int CAN_UNUSED_FRAME_PERIOD_MS = 255;
+	constexpr int TALON_CONTROL_FRAME_PERIOD_MS = 10;
+	constexpr double CAN_OTHER_FRAMES_PER_S = 150;
+	constexpr double CAN_BITS_PER_FRAME = 135;
+	constexpr double CAN_BIT_RATE = 1000000;
 
 	// Current Limiting Constants
 	constexpr int FORTY_AMP_FUSE_CONT_MAX = 50; // The continuous max current draw for a 40 amp breaker
@@ -66,13 +198,38 @@ namespace consts
 
 	// Encoder Constants
 	constexpr double PI = 3.1416;
-	constexpr double WHEEL_DIAMETER = 6;
-	constexpr double PULSES_PER_REV = 4096;
+	constexpr units::Inches WHEEL_DIAMETER = 6_in;
+	constexpr units::Inches ELEVATOR_DRUM_DIAMETER = 1.5_in;
+	constexpr units::Ticks PULSES_PER_REV = 4096_ticks;
+	constexpr units::InchesPerTick DRIVE_INCHES_PER_TICK = WHEEL_DIAMETER * PI / PULSES_PER_REV;
+	constexpr units::InchesPerTick ELEVATOR_INCHES_PER_TICK = ELEVATOR_DRUM_DIAMETER * PI / PULSES_PER_REV;
 
 	// PID Constants
 	constexpr int PID_LOOP_X = 0;
 	constexpr int TIMEOUT_MS = 10;
 
+	// Control loop constants
+	constexpr double CONTROL_PERIOD_S = 0.01;
+	constexpr int CONTROL_THREAD_PRIORITY = 40;  // Real-time priority of the ControlExecutor thread (1-99)
+	constexpr double PID_GAIN_PERIOD_S = 0.05;   // Loop period the PID gains were tuned at (frc::PIDController's default)
+	constexpr double ROBOT_PERIOD_S = 0.02;          // How often IterativeRobot calls the periodic functions
+	constexpr double TIMING_PUBLISH_PERIOD_S = 1;    // How often the loop timing summaries are sent
+	constexpr double TELEMETRY_PUBLISH_PERIOD_S = 0.1;  // How often the Telemetry thread sends changed values
+
+	// Match recorder constants
+	// - One record is written every control tick, so a file holds 5 minutes at 100Hz (about 6MB)
+	constexpr const char* MATCH_LOG_DIRECTORY = "/home/lvuser/logs";
+	constexpr int MATCH_LOG_MAX_RECORDS = 30000;
+	constexpr int MATCH_LOG_MAX_FILES = 20;       // The oldest logs are deleted past this
+	constexpr int REPLAY_STEPS_PER_LOOP = 25;     // Robot loops replayed per disabled loop, so 25x real time
+	constexpr double REPLAY_TOLERANCE = 1e-4;     // Allowed difference between replayed and recorded outputs
+
+	// Tracer constants
+	// - Each mode's timeline is written when the robot is disabled. Open it in chrome://tracing
+	constexpr bool TRACING_ENABLED = true;
+	constexpr const char* TRACE_DIRECTORY = "/home/lvuser/traces";
+	constexpr int TRACE_EXPORT_NICENESS = 19;   // Lowest Linux priority, so exports only use idle CPU time
+
 	// Intake Constants
 	constexpr double MIN_DISTANCE_TO_CUBE = 9.0;
 	constexpr double INTAKE_SPEED = 0.80;
@@ -0,0 +1,103 @@
+#include "CanBandwidthManager.h"
+#include "../Constants.h"
+
+CanBandwidthManager::CanBandwidthManager() :
+	m_talons()
+{
+
+}
+
+CanBandwidthManager::~CanBandwidthManager()
+{
+
+}
+
+void CanBandwidthManager::Add(WPI_TalonSRX& talon, TalonUsage usage, ControlLoop* loop)
+{
+	m_talons.push_back({&talon, usage, loop, false});
+}
+
+// Called once from RobotInit, where it's fine to wait for each Talon to confirm
+void CanBandwidthManager::Apply()
+{
+	for(unsigned int i = 0; i < m_talons.size(); i++)
+	{
+		WPI_TalonSRX& talon = *m_talons[i].talon;
+		TalonUsage usage = m_talons[i].usage;
+
+		talon.SetStatusFramePeriod(StatusFrameEnhanced::Status_1_General, GetGeneralPeriodMs(usage), consts::TALON_TIMEOUT_MS);
+		ApplyFeedbackPeriod(m_talons[i], consts::TALON_TIMEOUT_MS);
+		talon.SetStatusFramePeriod(StatusFrameEnhanced::Status_10_MotionMagic, GetOnboardLoopPeriodMs(usage), consts::TALON_TIMEOUT_MS);
+		talon.SetStatusFramePeriod(StatusFrameEnhanced::Status_13_Base_PIDF0, GetOnboardLoopPeriodMs(usage), consts::TALON_TIMEOUT_MS);
+
+		// The quadrature, pulse width and analog/temperature/battery frames are never read
+		talon.SetStatusFramePeriod(StatusFrameEnhanced::Status_3_Quadrature, consts::CAN_UNUSED_FRAME_PERIOD_MS, consts::TALON_TIMEOUT_MS);
+		talon.SetStatusFramePeriod(StatusFrameEnhanced::Status_4_AinTempVbat, consts::CAN_UNUSED_FRAME_PERIOD_MS, consts::TALON_TIMEOUT_MS);
+		talon.SetStatusFramePeriod(StatusFrameEnhanced::Status_8_PulseWidth, consts::CAN_UNUSED_FRAME_PERIOD_MS, consts::TALON_TIMEOUT_MS);
+	}
+}
+
+void CanBandwidthManager::Update()
+{
+	for(unsigned int i = 0; i < m_talons.size(); i++)
+	{
+		ManagedTalon& managed = m_talons[i];
+		if(managed.loop == nullptr) continue;
+
+		bool isLoopActive = managed.loop->IsEnabled();
+		if(isLoopActive != managed.isLoopActive)
+		{
+			managed.isLoopActive = isLoopActive;
+			ApplyFeedbackPeriod(managed, 0);
+		}
+	}
+}
+
+// Each frame is about 135 bits long once the extended ID, 8 data bytes and bit stuffing are counted.
+// The control frames and the other devices on the bus (PDP and PCM) are included as a fixed load
+double CanBandwidthManager::GetEstimatedUtilization()
+{
+	double framesPerSecond = consts::CAN_OTHER_FRAMES_PER_S;
+	for(unsigned int i = 0; i < m_talons.size(); i++)
+	{
+		TalonUsage usage = m_talons[i].usage;
+		framesPerSecond += 1000. / consts::TALON_CONTROL_FRAME_PERIOD_MS;
+		framesPerSecond += 1000. / GetGeneralPeriodMs(usage);
+		framesPerSecond += 1000. / GetFeedbackPeriodMs(m_talons[i]);
+		framesPerSecond += 2 * 1000. / GetOnboardLoopPeriodMs(usage);
+		framesPerSecond += 3 * 1000. / consts::CAN_UNUSED_FRAME_PERIOD_MS;
+	}
+
+	return framesPerSecond * consts::CAN_BITS_PER_FRAME / consts::CAN_BIT_RATE;
+}
+
+void CanBandwidthManager::ApplyFeedbackPeriod(ManagedTalon& managed, int timeoutMs)
+{
+	managed.talon->SetStatusFramePeriod(StatusFrameEnhanced::Status_2_Feedback0, GetFeedbackPeriodMs(managed), timeoutMs);
+}
+
+int CanBandwidthManager::GetFeedbackPeriodMs(const ManagedTalon& managed)
+{
+	switch(managed.usage)
+	{
+	case TalonUsage::ENCODER:
+	case TalonUsage::ONBOARD_LOOP:
+		return managed.isLoopActive ? consts::CAN_ACTIVE_FEEDBACK_PERIOD_MS : consts::CAN_FEEDBACK_PERIOD_MS;
+	case TalonUsage::CURRENT_MONITORED:
+		return consts::CAN_CURRENT_PERIOD_MS;
+	default:
+		return consts::CAN_UNUSED_FRAME_PERIOD_MS;
+	}
+}
+
+// The general frame carries the motor output and faults, which only matter for Talons we read from
+int CanBandwidthManager::GetGeneralPeriodMs(TalonUsage usage)
+{
+	return usage == TalonUsage::MOTOR_ONLY || usage == TalonUsage::CURRENT_MONITORED ?
+			consts::CAN_SLOW_GENERAL_PERIOD_MS : consts::CAN_GENERAL_PERIOD_MS;
+}
+
+int CanBandwidthManager::GetOnboardLoopPeriodMs(TalonUsage usage)
+{
+	return usage == TalonUsage::ONBOARD_LOOP ? consts::CAN_ONBOARD_LOOP_PERIOD_MS : consts::CAN_UNUSED_FRAME_PERIOD_MS;
+}
@@ -0,0 +1,56 @@
+#ifndef CAN_BANDWIDTH_MANAGER
+#define CAN_BANDWIDTH_MANAGER
+
+#include <WPILib.h>
+#include <ctre/Phoenix.h>
+#include <vector>
+#include "ControlLoop.h"
+
+using namespace frc;
+
+// What the robot code reads from a Talon, which decides how often it has to send each status frame
+enum class TalonUsage
+{
+	MOTOR_ONLY,          // Nothing is read back
+	CURRENT_MONITORED,   // Only the output current is read (it comes in the feedback frame)
+	ENCODER,             // The selected sensor is read, and maybe used by a roboRIO loop
+	ONBOARD_LOOP         // The Talon runs Motion Magic, so its targets and loop error are read too
+};
+
+// Sets every Talon's status frame periods from what the code actually reads from it. Frames
+// nobody reads are slowed down to the slowest period, and an encoder's feedback frame is sped
+// up while the ControlLoop that uses it is enabled. It also estimates the CAN bus load from
+// the frame rates it has set.
+// - Update() only sends a frame period when a loop has been enabled or disabled, and it doesn't
+//   wait for the Talon to answer, so it can run as a ControlExecutor output stage
+class CanBandwidthManager
+{
+private:
+	struct ManagedTalon
+	{
+		WPI_TalonSRX* talon;
+		TalonUsage usage;
+		ControlLoop* loop;
+		bool isLoopActive;
+	};
+
+	std::vector<ManagedTalon> m_talons;
+
+	void ApplyFeedbackPeriod(ManagedTalon& managed, int timeoutMs);
+	static int GetFeedbackPeriodMs(const ManagedTalon& managed);
+	static int GetGeneralPeriodMs(TalonUsage usage);
+	static int GetOnboardLoopPeriodMs(TalonUsage usage);
+
+public:
+	CanBandwidthManager();
+	virtual ~CanBandwidthManager();
+
+	// All Talons must be added before Apply() is called
+	void Add(WPI_TalonSRX& talon, TalonUsage usage, ControlLoop* loop = nullptr);
+	void Apply();
+	void Update();
+
+	double GetEstimatedUtilization();   // Fraction of the 1Mbit/s bus, from 0 to 1
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "ControlExecutor.h"
+#include "../Constants.h"
+#include <Threads.h>
+
+ControlExecutor::ControlExecutor(double period) :
+	m_notifier([this]() { Tick(); }),
+	m_period(period),
+	m_prevTime(0),
+	m_hasSetPriority(false),
+	m_loops(),
+	m_loopSources(),
+	m_sources(),
+	m_sourceInputs(),
+	m_isSourceRead(),
+	m_outputStages(),
+	m_tickTimer("Control Tick", period),
+	m_loopTimers()
+{
+
+}
+
+ControlExecutor::~ControlExecutor()
+{
+	Stop();
+}
+
+void ControlExecutor::Add(ControlLoop* loop, std::string name)
+{
+	// Loops that share a source (like the two angle loops) share one reading of it
+	unsigned int sourceIndex = 0;
+	while(sourceIndex < m_sources.size() && m_sources[sourceIndex] != &loop->GetSource())
+	{
+		sourceIndex++;
+	}
+	if(sourceIndex == m_sources.size())
+	{
+		m_sources.push_back(&loop->GetSource());
+		m_sourceInputs.push_back(0);
+		m_isSourceRead.push_back(false);
+	}
+
+	m_loops.push_back(loop);
+	m_loopSources.push_back(sourceIndex);
+	m_loopTimers.push_back(std::make_unique<LoopTimer>(name, m_period));
+}
+
+void ControlExecutor::AddOutputStage(std::function<void()> outputStage)
+{
+	m_outputStages.push_back(outputStage);
+}
+
+void ControlExecutor::Start()
+{
+	m_prevTime = Timer::GetFPGATimestamp();
+	m_notifier.StartPeriodic(m_period);
+}
+
+void ControlExecutor::Stop()
+{
+	m_notifier.Stop();
+}
+
+void ControlExecutor::Tick()
+{
+	// The Notifier thread can only raise its own priority from inside the thread
+	if(!m_hasSetPriority)
+	{
+		SetCurrentThreadPriority(true, consts::CONTROL_THREAD_PRIORITY);
+		Tracer::GetInstance().SetThreadName("Control");
+		m_hasSetPriority = true;
+	}
+	ScopedLoopTimer tickTiming(m_tickTimer);
+
+	double time = Timer::GetFPGATimestamp();
+	double dt = time - m_prevTime;
+	m_prevTime = time;
+
+	for(unsigned int i = 0; i < m_isSourceRead.size(); i++)
+	{
+		m_isSourceRead[i] = false;
+	}
+
+	for(unsigned int i = 0; i < m_loops.size(); i++)
+	{
+		if(!m_loops[i]->IsEnabled()) continue;
+
+		unsigned int source = m_loopSources[i];
+		if(!m_isSourceRead[source])
+		{
+			m_sourceInputs[source] = m_sources[source]->PIDGet();
+			m_isSourceRead[source] = true;
+		}
+		// Each loop's timing includes the PIDWrite() to its output
+		ScopedLoopTimer loopTiming(*m_loopTimers[i]);
+		m_loops[i]->Update(m_sourceInputs[source], dt);
+	}
+
+	ScopedTraceSpan outputSpan("Output Stages", "control");
+	for(unsigned int i = 0; i < m_outputStages.size(); i++)
+	{
+		m_outputStages[i]();
+	}
+}
+
+void ControlExecutor::PublishTiming()
+{
+	m_tickTimer.Publish();
+	for(unsigned int i = 0; i < m_loopTimers.size(); i++)
+	{
+		m_loopTimers[i]->Publish();
+	}
+}
+
+void ControlExecutor::ResetTiming()
+{
+	m_tickTimer.Reset();
+	for(unsigned int i = 0; i < m_loopTimers.size(); i++)
+	{
+		m_loopTimers[i]->Reset();
+	}
+}
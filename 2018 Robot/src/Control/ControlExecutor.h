@@ -0,0 +1,54 @@
+#ifndef CONTROL_EXECUTOR
+#define CONTROL_EXECUTOR
+
+#include <WPILib.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ControlLoop.h"
+#include "../Diagnostics/LoopTimer.h"
+
+using namespace frc;
+
+// Runs every ControlLoop on the robot from one fixed-rate, high priority thread. Each tick
+// reads every source used by an enabled loop exactly once, updates the enabled loops in the
+// order they were added and then runs the output stages, so loop timing and output order
+// are predictable
+class ControlExecutor
+{
+private:
+	Notifier m_notifier;
+	double m_period;
+	double m_prevTime;
+	bool m_hasSetPriority;
+
+	// All of these are sized in Add() so that a tick never allocates
+	std::vector<ControlLoop*> m_loops;
+	std::vector<unsigned int> m_loopSources;   // Index into m_sources for each loop
+	std::vector<PIDSource*> m_sources;
+	std::vector<double> m_sourceInputs;
+	std::vector<bool> m_isSourceRead;
+	std::vector<std::function<void()>> m_outputStages;
+
+	LoopTimer m_tickTimer;
+	std::vector<std::unique_ptr<LoopTimer>> m_loopTimers;
+
+	void Tick();
+
+public:
+	ControlExecutor(double period);
+	virtual ~ControlExecutor();
+
+	// Loops must all be added before Start() is called
+	void Add(ControlLoop* loop, std::string name);
+	// Output stages run after every loop has been updated, e.g. to send one drive command per tick
+	void AddOutputStage(std::function<void()> outputStage);
+	void Start();
+	// Waits for a tick that's in progress, so nothing the loops and output stages use is touched afterwards
+	void Stop();
+	void PublishTiming();
+	void ResetTiming();
+};
+
+#endif
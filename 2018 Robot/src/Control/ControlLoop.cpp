@@ -0,0 +1,211 @@
+#include "ControlLoop.h"
+#include "../Constants.h"
+#include <cmath>
+
+ControlLoop::ControlLoop(double p, double i, double d, PIDSource& source, PIDOutput& output) :
+	SendableBase(false),
+	m_source(source),
+	m_output(output),
+	m_P(p),
+	m_I(i),
+	m_D(d),
+	m_minimumOutput(-1.0),
+	m_maximumOutput(1.0),
+	m_tolerance(-1),
+	m_setpoint(0),
+	m_feedforward(nullptr),
+	m_onboardController(nullptr),
+	m_input(0),
+	m_prevError(0),
+	m_totalError(0),
+	m_result(0),
+	m_isEnabled(false),
+	m_mutex()
+{
+
+}
+
+ControlLoop::~ControlLoop()
+{
+
+}
+
+void ControlLoop::Update(double input, double dt)
+{
+	double result;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_input = input;
+		if(!m_isEnabled || dt <= 0) return;
+
+		// The onboard controller only queues a CAN frame, so it's fine to call under the lock
+		if(m_onboardController)
+		{
+			m_onboardController(m_setpoint);
+			return;
+		}
+
+		double error = m_setpoint - input;
+
+		// Keep the integral from growing past what the output range can use
+		if(m_I != 0)
+		{
+			m_totalError += error * dt / consts::PID_GAIN_PERIOD_S;
+			m_totalError = std::fmax(m_minimumOutput / m_I, std::fmin(m_maximumOutput / m_I, m_totalError));
+		}
+
+		double derivative = (error - m_prevError) * consts::PID_GAIN_PERIOD_S / dt;
+		m_result = m_P * error + m_I * m_totalError + m_D * derivative;
+		if(m_feedforward) m_result += m_feedforward();
+		m_result = std::fmax(m_minimumOutput, std::fmin(m_maximumOutput, m_result));
+		m_prevError = error;
+		result = m_result;
+	}
+
+	// Write outside of the lock like frc::PIDController does
+	m_output.PIDWrite(result);
+}
+
+PIDSource& ControlLoop::GetSource()
+{
+	return m_source;
+}
+
+void ControlLoop::Enable()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_isEnabled = true;
+}
+
+void ControlLoop::Disable()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isEnabled = false;
+	}
+	m_output.PIDWrite(0);
+}
+
+void ControlLoop::SetEnabled(bool enable)
+{
+	if(enable) Enable();
+	else       Disable();
+}
+
+bool ControlLoop::IsEnabled() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_isEnabled;
+}
+
+void ControlLoop::Reset()
+{
+	Disable();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_prevError = 0;
+	m_totalError = 0;
+	m_result = 0;
+}
+
+void ControlLoop::SetPID(double p, double i, double d)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_P = p;
+	m_I = i;
+	m_D = d;
+}
+
+double ControlLoop::GetP() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_P;
+}
+
+double ControlLoop::GetI() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_I;
+}
+
+double ControlLoop::GetD() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_D;
+}
+
+void ControlLoop::SetSetpoint(double setpoint)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_setpoint = setpoint;
+}
+
+double ControlLoop::GetSetpoint() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_setpoint;
+}
+
+void ControlLoop::SetAbsoluteTolerance(double tolerance)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_tolerance = tolerance;
+}
+
+void ControlLoop::SetOutputRange(double minimumOutput, double maximumOutput)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_minimumOutput = minimumOutput;
+	m_maximumOutput = maximumOutput;
+}
+
+void ControlLoop::SetFeedforward(std::function<double()> feedforward)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_feedforward = feedforward;
+}
+
+void ControlLoop::SetOnboardController(std::function<void(double)> onboardController)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_onboardController = onboardController;
+}
+
+double ControlLoop::Get() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_result;
+}
+
+// The source reading from the last control tick
+double ControlLoop::GetInput() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_input;
+}
+
+// Uses the reading from the last control tick instead of reading the source again
+double ControlLoop::GetError() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_setpoint - m_input;
+}
+
+bool ControlLoop::OnTarget() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_tolerance >= 0 && std::fabs(m_setpoint - m_input) < m_tolerance;
+}
+
+void ControlLoop::InitSendable(SendableBuilder& builder)
+{
+	// Show up on the dashboards the same way an frc::PIDController does
+	builder.SetSmartDashboardType("PIDController");
+	builder.SetSafeState([=]() { Reset(); });
+	builder.AddDoubleProperty("p", [=]() { return GetP(); }, [=](double p) { SetPID(p, GetI(), GetD()); });
+	builder.AddDoubleProperty("i", [=]() { return GetI(); }, [=](double i) { SetPID(GetP(), i, GetD()); });
+	builder.AddDoubleProperty("d", [=]() { return GetD(); }, [=](double d) { SetPID(GetP(), GetI(), d); });
+	builder.AddDoubleProperty("f", [=]() { return 0.0; }, nullptr);
+	builder.AddDoubleProperty("setpoint", [=]() { return GetSetpoint(); }, [=](double setpoint) { SetSetpoint(setpoint); });
+	builder.AddBooleanProperty("enabled", [=]() { return IsEnabled(); }, [=](bool enable) { SetEnabled(enable); });
+}
@@ -0,0 +1,76 @@
+#ifndef CONTROL_LOOP
+#define CONTROL_LOOP
+
+#include <WPILib.h>
+#include <functional>
+#include <mutex>
+
+using namespace frc;
+
+// A PID loop with the same interface as frc::PIDController, except that it doesn't own a
+// thread. The ControlExecutor reads its source and calls Update() at a fixed rate together
+// with every other loop on the robot.
+// - An optional feedforward is added to the PID output while the loop is enabled
+// - If an onboard controller is set, the loop hands it the setpoint every update instead of
+//   running the PID itself, e.g. to let a Talon close the loop. Disable() still writes 0
+// - The gains keep the units they were tuned in with frc::PIDController's 50ms period
+//   (see consts::PID_GAIN_PERIOD_S), so I and D are scaled by the real time between updates
+class ControlLoop : public SendableBase
+{
+private:
+	PIDSource& m_source;
+	PIDOutput& m_output;
+
+	double m_P;
+	double m_I;
+	double m_D;
+	double m_minimumOutput;
+	double m_maximumOutput;
+	double m_tolerance;      // A negative tolerance means none was set
+	double m_setpoint;
+	std::function<double()> m_feedforward;
+	std::function<void(double)> m_onboardController;
+
+	double m_input;
+	double m_prevError;
+	double m_totalError;
+	double m_result;
+	bool m_isEnabled;
+
+	mutable std::mutex m_mutex;
+
+public:
+	ControlLoop(double p, double i, double d, PIDSource& source, PIDOutput& output);
+	virtual ~ControlLoop();
+
+	// Called by the ControlExecutor with this tick's reading of the source
+	void Update(double input, double dt);
+	PIDSource& GetSource();
+
+	void Enable();
+	void Disable();
+	void SetEnabled(bool enable);
+	bool IsEnabled() const;
+	void Reset();
+
+	void SetPID(double p, double i, double d);
+	double GetP() const;
+	double GetI() const;
+	double GetD() const;
+
+	void SetSetpoint(double setpoint);
+	double GetSetpoint() const;
+	void SetAbsoluteTolerance(double tolerance);
+	void SetOutputRange(double minimumOutput, double maximumOutput);
+	void SetFeedforward(std::function<double()> feedforward);
+	void SetOnboardController(std::function<void(double)> onboardController);
+
+	double Get() const;
+	double GetInput() const;
+	double GetError() const;
+	bool OnTarget() const;
+
+	void InitSendable(SendableBuilder& builder) override;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#include "DriveMixer.h"
+#include "../Robot.h"
+
+DriveMixer::DriveMixer(DifferentialDrive& driveTrain) :
+	m_driveTrain(driveTrain),
+	m_forward(0),
+	m_turn(0),
+	m_hasOutput(false),
+	m_mutex()
+{
+
+}
+
+DriveMixer::~DriveMixer()
+{
+
+}
+
+void DriveMixer::AddForward(double forward)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_forward += forward;
+	m_hasOutput = true;
+}
+
+void DriveMixer::AddTurn(double turn)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_turn += turn;
+	m_hasOutput = true;
+}
+
+void DriveMixer::Commit()
+{
+	double forward;
+	double turn;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if(!m_hasOutput) return;
+
+		forward = limit(m_forward);
+		turn = limit(m_turn);
+		m_forward = 0;
+		m_turn = 0;
+		m_hasOutput = false;
+	}
+
+	m_driveTrain.ArcadeDrive(forward, turn, false);
+}
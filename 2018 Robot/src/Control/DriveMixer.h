@@ -0,0 +1,32 @@
+#ifndef DRIVE_MIXER
+#define DRIVE_MIXER
+
+#include <WPILib.h>
+#include <mutex>
+
+using namespace frc;
+
+// Collects the forward and turning outputs of every drive loop during a control tick and
+// sends them to the drive train as one ArcadeDrive command when the tick ends, instead of
+// each loop driving the robot with a stale copy of the other loop's output
+class DriveMixer
+{
+private:
+	DifferentialDrive& m_driveTrain;
+	double m_forward;
+	double m_turn;
+	bool m_hasOutput;    // Only drive if a loop wrote something since the last commit
+	std::mutex m_mutex;
+
+public:
+	DriveMixer(DifferentialDrive& driveTrain);
+	virtual ~DriveMixer();
+
+	void AddForward(double forward);
+	void AddTurn(double turn);
+
+	// Called by the ControlExecutor at the end of every tick
+	void Commit();
+};
+
+#endif
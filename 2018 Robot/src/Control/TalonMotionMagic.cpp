@@ -0,0 +1,59 @@
+#include "TalonMotionMagic.h"
+#include "../Constants.h"
+#include <cmath>
+
+TalonMotionMagic::TalonMotionMagic(WPI_TalonSRX& leader, WPI_TalonSRX* follower, double pulsesPerUnit) :
+	m_leader(leader),
+	m_follower(follower),
+	m_pulsesPerUnit(pulsesPerUnit),
+	m_target(0),
+	m_feedforward(0)
+{
+
+}
+
+TalonMotionMagic::~TalonMotionMagic()
+{
+
+}
+
+void TalonMotionMagic::Configure(double p, double d, double kV, double maxVelocity, double maxAcceleration)
+{
+	// The Talon's gains are in 1023 output units per pulse of error, and its velocities are per 100ms.
+	// Its derivative is taken every 1ms, where the roboRIO gains were tuned every 50ms
+	double pulsesPer100ms = m_pulsesPerUnit / 10;
+	m_leader.Config_kP(consts::MOTION_MAGIC_SLOT, p * 1023 / m_pulsesPerUnit, consts::TALON_TIMEOUT_MS);
+	m_leader.Config_kI(consts::MOTION_MAGIC_SLOT, 0, consts::TALON_TIMEOUT_MS);
+	m_leader.Config_kD(consts::MOTION_MAGIC_SLOT, d * 1023 / m_pulsesPerUnit * consts::PID_GAIN_PERIOD_S / 0.001,
+			consts::TALON_TIMEOUT_MS);
+	m_leader.Config_kF(consts::MOTION_MAGIC_SLOT, kV * 1023 / pulsesPer100ms, consts::TALON_TIMEOUT_MS);
+	m_leader.SelectProfileSlot(consts::MOTION_MAGIC_SLOT, consts::PID_LOOP_ID);
+
+	m_leader.ConfigMotionCruiseVelocity((int)(maxVelocity * pulsesPer100ms), consts::TALON_TIMEOUT_MS);
+	m_leader.ConfigMotionAcceleration((int)(maxAcceleration * pulsesPer100ms), consts::TALON_TIMEOUT_MS);
+}
+
+void TalonMotionMagic::SetTarget(double target, double feedforward)
+{
+	// Only send a new frame when something changed, since the Talon keeps running the last one
+	if(IsActive() && target == m_target && std::fabs(feedforward - m_feedforward) < FEEDFORWARD_RESEND_THRESHOLD)
+	{
+		return;
+	}
+
+	if(m_follower != nullptr) m_follower->Follow(m_leader);
+	m_leader.Set(ControlMode::MotionMagic, target * m_pulsesPerUnit,
+			DemandType::DemandType_ArbitraryFeedForward, feedforward);
+	m_target = target;
+	m_feedforward = feedforward;
+}
+
+bool TalonMotionMagic::IsActive()
+{
+	return m_leader.GetControlMode() == ControlMode::MotionMagic;
+}
+
+double TalonMotionMagic::GetError()
+{
+	return m_leader.GetClosedLoopError(consts::PID_LOOP_ID) / m_pulsesPerUnit;
+}
@@ -0,0 +1,38 @@
+#ifndef TALON_MOTION_MAGIC
+#define TALON_MOTION_MAGIC
+
+#include <WPILib.h>
+#include <ctre/Phoenix.h>
+
+using namespace frc;
+
+// Runs a position loop on a Talon SRX's onboard 1kHz Motion Magic controller instead of on the
+// roboRIO. The Talon reads its own encoder and plans its own trapezoidal profile, so the roboRIO
+// only sends a new frame when the target or the arbitrary feedforward changes.
+// - Positions, velocities and gains are given in the robot's units (e.g. inches) and converted
+//   to the Talon's native units (pulses, pulses per 100ms and 1023 = full output)
+// - If the leader has been switched to another control mode (e.g. a manual Set()), the next
+//   SetTarget() resends the target and puts the follower back into follower mode
+class TalonMotionMagic
+{
+private:
+	WPI_TalonSRX& m_leader;
+	WPI_TalonSRX* m_follower;
+	double m_pulsesPerUnit;
+	double m_target;
+	double m_feedforward;
+
+	static constexpr double FEEDFORWARD_RESEND_THRESHOLD = 0.01;
+
+public:
+	TalonMotionMagic(WPI_TalonSRX& leader, WPI_TalonSRX* follower, double pulsesPerUnit);
+	virtual ~TalonMotionMagic();
+
+	// p is in motor output per unit of error and kV in motor output per unit per second
+	void Configure(double p, double d, double kV, double maxVelocity, double maxAcceleration);
+	void SetTarget(double target, double feedforward = 0);
+	bool IsActive();
+	double GetError();
+};
+
+#endif
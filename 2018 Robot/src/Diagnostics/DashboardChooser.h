@@ -0,0 +1,82 @@
+#ifndef DASHBOARD_CHOOSER
+#define DASHBOARD_CHOOSER
+
+#include <WPILib.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace frc;
+
+// A SendableChooser that remembers its last selection, so the robot code only reacts (and only
+// republishes anything built from it) when the selection actually changes.
+// - Each option has a short label for summaries, formatted once when the option is added
+// - Update() reads the chooser, GetSelected() and GetSelectedLabel() only return the cached selection
+template<typename T>
+class DashboardChooser
+{
+private:
+	SendableChooser<T> m_chooser;
+	std::vector<std::pair<T, std::string>> m_labels;
+	T m_selected;
+	bool m_hasSelected;
+	int m_selectedIndex;   // Index into m_labels, or -1 if the selection has no label
+	std::string m_noLabel;
+
+public:
+	DashboardChooser() :
+		m_chooser(),
+		m_labels(),
+		m_selected(),
+		m_hasSelected(false),
+		m_selectedIndex(-1),
+		m_noLabel()
+	{
+
+	}
+
+	void AddOption(const std::string& name, T value, const std::string& label)
+	{
+		m_chooser.AddObject(name, value);
+		m_labels.push_back(std::make_pair(value, label));
+	}
+
+	void AddDefault(const std::string& name, T value, const std::string& label)
+	{
+		m_chooser.AddDefault(name, value);
+		m_labels.push_back(std::make_pair(value, label));
+	}
+
+	void Publish(const std::string& key)
+	{
+		SmartDashboard::PutData(key, &m_chooser);
+	}
+
+	// Returns true if the selection changed since the last update
+	bool Update()
+	{
+		T selected = m_chooser.GetSelected();
+		if(m_hasSelected && selected == m_selected) return false;
+
+		m_selected = selected;
+		m_hasSelected = true;
+		m_selectedIndex = -1;
+		for(unsigned int i = 0; i < m_labels.size(); i++)
+		{
+			if(m_labels[i].first == selected) m_selectedIndex = i;
+		}
+		return true;
+	}
+
+	T GetSelected() const
+	{
+		return m_selected;
+	}
+
+	const std::string& GetSelectedLabel() const
+	{
+		return m_selectedIndex >= 0 ? m_labels[m_selectedIndex].second : m_noLabel;
+	}
+};
+
+#endif
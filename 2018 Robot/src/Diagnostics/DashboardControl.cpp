@@ -0,0 +1,82 @@
+#include "DashboardControl.h"
+#include <networktables/NetworkTableInstance.h>
+
+// The entry isn't looked up in the constructor, since the robot's members are built before
+// NetworkTables has started
+static nt::NetworkTableEntry GetDashboardEntry(const std::string& key)
+{
+	return nt::NetworkTableInstance::GetDefault().GetTable("SmartDashboard")->GetEntry(key);
+}
+
+DashboardBoolean::DashboardBoolean(std::string key, bool defaultValue) :
+	m_key(key),
+	m_defaultValue(defaultValue),
+	m_entry(),
+	m_hasEntry(false)
+{
+
+}
+
+nt::NetworkTableEntry& DashboardBoolean::GetEntry()
+{
+	if(!m_hasEntry)
+	{
+		m_entry = GetDashboardEntry(m_key);
+		m_hasEntry = true;
+	}
+	return m_entry;
+}
+
+bool DashboardBoolean::Get()
+{
+	return GetEntry().GetBoolean(m_defaultValue);
+}
+
+void DashboardBoolean::Set(bool value)
+{
+	// A missing entry or one of another type reads back as !value, so it's always sent
+	nt::NetworkTableEntry& entry = GetEntry();
+	if(entry.GetBoolean(!value) == value) return;
+	entry.SetBoolean(value);
+}
+
+void DashboardBoolean::Reset()
+{
+	Set(m_defaultValue);
+}
+
+DashboardNumber::DashboardNumber(std::string key, double defaultValue) :
+	m_key(key),
+	m_defaultValue(defaultValue),
+	m_entry(),
+	m_hasEntry(false)
+{
+
+}
+
+nt::NetworkTableEntry& DashboardNumber::GetEntry()
+{
+	if(!m_hasEntry)
+	{
+		m_entry = GetDashboardEntry(m_key);
+		m_hasEntry = true;
+	}
+	return m_entry;
+}
+
+double DashboardNumber::Get()
+{
+	return GetEntry().GetDouble(m_defaultValue);
+}
+
+void DashboardNumber::Set(double value)
+{
+	nt::NetworkTableEntry& entry = GetEntry();
+	if(entry.GetType() == nt::NetworkTableType::kDouble && entry.GetDouble(value) == value) return;
+	entry.SetDouble(value);
+}
+
+void DashboardNumber::Reset()
+{
+	Set(m_defaultValue);
+}
@@ -0,0 +1,48 @@
+#ifndef DASHBOARD_CONTROL
+#define DASHBOARD_CONTROL
+
+#include <networktables/NetworkTableEntry.h>
+#include <string>
+
+// A value on the SmartDashboard that the drivers or programmers set, such as a test toggle or a
+// tuning number. The entry is looked up once, so reading it doesn't hash the key every loop.
+// - Set() and Reset() only send the value when it differs from what the dashboard already has,
+//   so resetting every control in an Init function costs no NetworkTables traffic when nothing changed
+// - Only used from the main robot thread
+class DashboardBoolean
+{
+private:
+	std::string m_key;
+	bool m_defaultValue;
+	nt::NetworkTableEntry m_entry;
+	bool m_hasEntry;
+
+	nt::NetworkTableEntry& GetEntry();
+
+public:
+	DashboardBoolean(std::string key, bool defaultValue);
+
+	bool Get();
+	void Set(bool value);
+	void Reset();   // Puts the control back to its default value
+};
+
+class DashboardNumber
+{
+private:
+	std::string m_key;
+	double m_defaultValue;
+	nt::NetworkTableEntry m_entry;
+	bool m_hasEntry;
+
+	nt::NetworkTableEntry& GetEntry();
+
+public:
+	DashboardNumber(std::string key, double defaultValue);
+
+	double Get();
+	void Set(double value);
+	void Reset();   // Puts the control back to its default value
+};
+
+#endif
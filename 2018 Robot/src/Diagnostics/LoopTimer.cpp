@@ -0,0 +1,151 @@
+#include "LoopTimer.h"
+#include <WPILib.h>
+#include <cmath>
+
+using namespace frc;
+
+constexpr int TimingHistogram::NUM_BINS;
+constexpr double TimingHistogram::BIN_WIDTH_S;
+constexpr double LoopTimer::PAUSE_FACTOR;
+
+TimingHistogram::TimingHistogram() :
+	m_count(0),
+	m_maxMicroseconds(0)
+{
+	for(int i = 0; i < NUM_BINS; i++)
+	{
+		m_bins[i] = 0;
+	}
+}
+
+void TimingHistogram::Record(double seconds)
+{
+	int bin = (int)(seconds / BIN_WIDTH_S);
+	if(bin < 0) bin = 0;
+	if(bin >= NUM_BINS) bin = NUM_BINS - 1;
+	m_bins[bin]++;
+	m_count++;
+
+	long long microseconds = (long long)(seconds * 1e6);
+	long long prevMax = m_maxMicroseconds.load();
+	while(microseconds > prevMax && !m_maxMicroseconds.compare_exchange_weak(prevMax, microseconds))
+	{
+		// compare_exchange_weak reloads prevMax if another thread recorded a new max first
+	}
+}
+
+void TimingHistogram::Reset()
+{
+	for(int i = 0; i < NUM_BINS; i++)
+	{
+		m_bins[i] = 0;
+	}
+	m_count = 0;
+	m_maxMicroseconds = 0;
+}
+
+unsigned int TimingHistogram::GetCount()
+{
+	return m_count;
+}
+
+double TimingHistogram::GetPercentile(double percentile)
+{
+	unsigned int count = m_count;
+	if(count == 0) return 0;
+
+	// The overflow bin has no upper edge, so anything that lands in it reports the max instead
+	unsigned int target = (unsigned int)std::ceil(count * percentile / 100);
+	unsigned int seen = 0;
+	for(int i = 0; i < NUM_BINS - 1; i++)
+	{
+		seen += m_bins[i];
+		if(seen >= target) return (i + 1) * BIN_WIDTH_S;
+	}
+	return GetMax();
+}
+
+double TimingHistogram::GetMax()
+{
+	return m_maxMicroseconds / 1e6;
+}
+
+LoopTimer::LoopTimer(std::string name, double expectedPeriod) :
+	m_name(name),
+	m_expectedPeriod(expectedPeriod),
+	m_startTime(),
+	m_prevStartTime(),
+	m_hasStarted(false),
+	m_period(),
+	m_jitter(),
+	m_execution(),
+	m_overruns(0)
+{
+
+}
+
+LoopTimer::~LoopTimer()
+{
+
+}
+
+void LoopTimer::Start()
+{
+	m_startTime = Clock::now();
+	if(m_hasStarted)
+	{
+		double period = std::chrono::duration<double>(m_startTime - m_prevStartTime).count();
+		if(period < m_expectedPeriod * PAUSE_FACTOR)
+		{
+			m_period.Record(period);
+			m_jitter.Record(std::fabs(period - m_expectedPeriod));
+		}
+	}
+	m_prevStartTime = m_startTime;
+	m_hasStarted = true;
+}
+
+void LoopTimer::Stop()
+{
+	double execution = std::chrono::duration<double>(Clock::now() - m_startTime).count();
+	m_execution.Record(execution);
+	if(execution > m_expectedPeriod) m_overruns++;
+}
+
+void LoopTimer::Reset()
+{
+	m_period.Reset();
+	m_jitter.Reset();
+	m_execution.Reset();
+	m_overruns = 0;
+}
+
+// All times are published in milliseconds
+void LoopTimer::Publish()
+{
+	std::string prefix = "Timing/" + m_name + "/";
+	SmartDashboard::PutNumber(prefix + "Period p50", m_period.GetPercentile(50) * 1000);
+	SmartDashboard::PutNumber(prefix + "Period Max", m_period.GetMax() * 1000);
+	SmartDashboard::PutNumber(prefix + "Jitter p99", m_jitter.GetPercentile(99) * 1000);
+	SmartDashboard::PutNumber(prefix + "Execution p50", m_execution.GetPercentile(50) * 1000);
+	SmartDashboard::PutNumber(prefix + "Execution p99", m_execution.GetPercentile(99) * 1000);
+	SmartDashboard::PutNumber(prefix + "Execution Max", m_execution.GetMax() * 1000);
+	SmartDashboard::PutNumber(prefix + "Overruns", m_overruns);
+}
+
+const std::string& LoopTimer::GetName()
+{
+	return m_name;
+}
+
+ScopedLoopTimer::ScopedLoopTimer(LoopTimer& timer) :
+	m_timer(timer),
+	m_span(timer.GetName().c_str(), "loop")
+{
+	m_timer.Start();
+}
+
+ScopedLoopTimer::~ScopedLoopTimer()
+{
+	m_timer.Stop();
+}
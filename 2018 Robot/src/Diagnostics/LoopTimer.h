@@ -0,0 +1,78 @@
+#ifndef LOOP_TIMER
+#define LOOP_TIMER
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include "Tracer.h"
+
+// Histogram of durations with fixed 0.1ms bins up to 50ms and one overflow bin. Recording is
+// a single atomic increment, so it can be filled from a control thread while the main thread
+// reads percentiles from it
+class TimingHistogram
+{
+private:
+	static constexpr int NUM_BINS = 501;
+	static constexpr double BIN_WIDTH_S = 0.0001;
+
+	std::atomic<unsigned int> m_bins[NUM_BINS];
+	std::atomic<unsigned int> m_count;
+	std::atomic<long long> m_maxMicroseconds;
+
+public:
+	TimingHistogram();
+
+	void Record(double seconds);
+	void Reset();
+	unsigned int GetCount();
+	double GetPercentile(double percentile);   // The upper edge of the bin the percentile falls in
+	double GetMax();
+};
+
+// Measures how often a periodic function or control loop runs, how far each period is from the
+// expected period, how long each run takes and how often a run takes longer than the period.
+// Start() and Stop() only read a steady clock and fill the histograms, so it's cheap enough to
+// leave on in matches. Publish() sends a summary to the dashboard and should be called at a low rate
+// - A period longer than PAUSE_FACTOR times the expected period means the function was paused
+//   (e.g. its loop was disabled), so it isn't counted
+class LoopTimer
+{
+private:
+	typedef std::chrono::steady_clock Clock;
+	static constexpr double PAUSE_FACTOR = 10;
+
+	std::string m_name;
+	double m_expectedPeriod;
+	Clock::time_point m_startTime;
+	Clock::time_point m_prevStartTime;
+	bool m_hasStarted;
+
+	TimingHistogram m_period;
+	TimingHistogram m_jitter;
+	TimingHistogram m_execution;
+	std::atomic<unsigned int> m_overruns;
+
+public:
+	LoopTimer(std::string name, double expectedPeriod);
+	virtual ~LoopTimer();
+
+	void Start();
+	void Stop();
+	void Reset();   // Safe to call while another thread is timing, like the histograms
+	void Publish();
+	const std::string& GetName();
+};
+
+// Times the scope it's declared in, e.g. the body of a periodic function, and adds it to the trace
+class ScopedLoopTimer
+{
+private:
+	LoopTimer& m_timer;
+	ScopedTraceSpan m_span;
+
+public:
+	ScopedLoopTimer(LoopTimer& timer);
+	~ScopedLoopTimer();
+};
+
+#endif
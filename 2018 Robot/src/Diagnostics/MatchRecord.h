@@ -0,0 +1,89 @@
+#ifndef MATCH_RECORD
+#define MATCH_RECORD
+
+#include <cstdint>
+
+// Fixed layout of the match log files written by the MatchRecorder. A file is one MatchLogHeader
+// followed by numRecords MatchRecords, written in the roboRIO's native (little endian) byte order.
+// Change MATCH_LOG_VERSION whenever a field is added, removed or moved.
+// - Values are stored as floats to keep a match under 6MB at 100Hz, except for the timestamp
+// - Fields are ordered largest first so that there's no padding on either the roboRIO or a laptop
+
+constexpr char MATCH_LOG_MAGIC[8] = {'F', 'R', 'C', 'L', 'O', 'G', '1', '8'};
+constexpr uint32_t MATCH_LOG_VERSION = 2;
+
+struct MatchLogHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t recordSize;
+	uint64_t numRecords;   // Updated after every record, so a log cut off by a brownout can still be read
+};
+
+enum RecordedTalon
+{
+	FRONT_LEFT_TALON,
+	BACK_LEFT_TALON,
+	FRONT_RIGHT_TALON,
+	BACK_RIGHT_TALON,
+	RIGHT_ELEVATOR_TALON,
+	LEFT_ELEVATOR_TALON,
+	RIGHT_INTAKE_TALON,
+	LEFT_INTAKE_TALON,
+	LINKAGE_TALON,
+	NUM_RECORDED_TALONS
+};
+
+enum RecordedLoop
+{
+	ANGLE_LOOP,
+	MAINTAIN_ANGLE_LOOP,
+	DISTANCE_LOOP,
+	ELEVATOR_LOOP,
+	NUM_RECORDED_LOOPS
+};
+
+enum RecordedMode
+{
+	DISABLED_MODE,
+	AUTONOMOUS_MODE,
+	TELEOP_MODE,
+	TEST_MODE
+};
+
+// The six axes of a controller, in the order of ControllerSnapshot
+constexpr int NUM_RECORDED_AXES = 6;
+
+struct MatchRecord
+{
+	double timestamp;                    // FPGA time in seconds when the record was written
+	double snapshotTimestamp;            // FPGA time of the SensorSnapshot the sensor values come from
+
+	float elevatorHeight;
+	float elevatorVelocity;
+	float leftDriveDistance;
+	float leftDriveVelocity;
+	float rightDriveDistance;
+	float angle;
+	float angularRate;
+
+	float driveAxes[NUM_RECORDED_AXES];
+	float operatorAxes[NUM_RECORDED_AXES];
+
+	float talonCurrents[NUM_RECORDED_TALONS];   // Amps
+	float talonCommands[NUM_RECORDED_TALONS];   // Last percent output set on each Talon
+
+	float loopSetpoints[NUM_RECORDED_LOOPS];
+	float loopOutputs[NUM_RECORDED_LOOPS];
+
+	uint16_t driveButtons;               // Bit i is button i + 1 in the order of ControllerSnapshot
+	uint16_t operatorButtons;
+	uint8_t enabledLoops;                // Bit i is set if RecordedLoop i is enabled
+	uint8_t robotMode;                   // RecordedMode
+	uint8_t reserved[6];                 // Keeps the record a multiple of 8 bytes without implicit padding
+};
+
+static_assert(sizeof(MatchLogHeader) == 24, "The match log header layout changed, update MATCH_LOG_VERSION");
+static_assert(sizeof(MatchRecord) == 208, "The match record layout changed, update MATCH_LOG_VERSION");
+
+#endif
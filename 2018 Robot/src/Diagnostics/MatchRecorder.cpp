@@ -0,0 +1,175 @@
+#include "MatchRecorder.h"
+#include <WPILib.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace frc;
+
+MatchRecorder::MatchRecorder(std::string directory, size_t maxRecords, int maxFiles) :
+	m_directory(directory),
+	m_maxRecords(maxRecords),
+	m_maxFiles(maxFiles),
+	m_numPrepared(0),
+	m_next(nullptr),
+	m_pending(nullptr),
+	m_current(nullptr),
+	m_retired(nullptr)
+{
+
+}
+
+// The recording thread must have stopped before the recorder is destroyed
+MatchRecorder::~MatchRecorder()
+{
+	Close(m_retired.exchange(nullptr));
+	Close(m_current);
+	Close(m_pending.exchange(nullptr));
+	Close(m_next);
+}
+
+void MatchRecorder::Prepare()
+{
+	if(m_next != nullptr) return;
+
+	DeleteOldLogs();
+	m_next = Open();
+}
+
+// Names the log after the time the match started and the given name, e.g. "20180324_143512_Q12.bin"
+void MatchRecorder::Rotate(std::string name)
+{
+	Prepare();
+	if(m_next == nullptr) return;
+
+	char time[32];
+	std::time_t now = std::time(nullptr);
+	std::strftime(time, sizeof(time), "%Y%m%d_%H%M%S", std::localtime(&now));
+	std::string path = m_directory + "/" + time + "_" + name + ".bin";
+	if(std::rename(m_next->path.c_str(), path.c_str()) == 0)
+	{
+		m_next->path = path;
+	}
+
+	// If the last file handed over hasn't been picked up yet, it's still empty and is kept for the next match
+	m_next = m_pending.exchange(m_next);
+}
+
+void MatchRecorder::Maintain()
+{
+	Close(m_retired.exchange(nullptr));
+}
+
+// Called from the recording thread only
+void MatchRecorder::Record(const MatchRecord& record)
+{
+	// Only switch files once the main thread has taken the last finished one, so none are lost
+	if(m_pending.load() != nullptr && m_retired.load() == nullptr)
+	{
+		m_retired.store(m_current);
+		m_current = m_pending.exchange(nullptr);
+	}
+
+	if(m_current == nullptr || m_current->numRecords >= m_maxRecords) return;
+
+	std::memcpy(m_current->data + sizeof(MatchLogHeader) + m_current->numRecords * sizeof(MatchRecord),
+			&record, sizeof(MatchRecord));
+	m_current->numRecords++;
+	reinterpret_cast<MatchLogHeader*>(m_current->data)->numRecords = m_current->numRecords;
+}
+
+size_t MatchRecorder::GetFileSize()
+{
+	return sizeof(MatchLogHeader) + m_maxRecords * sizeof(MatchRecord);
+}
+
+MatchRecorder::LogFile* MatchRecorder::Open()
+{
+	mkdir(m_directory.c_str(), 0755);
+
+	// The file gets its real name when the match starts
+	std::string path = m_directory + "/next_" + std::to_string(m_numPrepared++) + ".bin.tmp";
+	int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+	{
+		DriverStation::ReportError("Match recorder can't create " + path);
+		return nullptr;
+	}
+
+	size_t size = GetFileSize();
+	void* data = MAP_FAILED;
+	if(ftruncate(fd, size) == 0)
+	{
+		data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+	}
+	if(data == MAP_FAILED)
+	{
+		DriverStation::ReportError("Match recorder can't map " + path);
+		close(fd);
+		unlink(path.c_str());
+		return nullptr;
+	}
+
+	MatchLogHeader header;
+	std::memcpy(header.magic, MATCH_LOG_MAGIC, sizeof(header.magic));
+	header.version = MATCH_LOG_VERSION;
+	header.recordSize = sizeof(MatchRecord);
+	header.numRecords = 0;
+	std::memcpy(data, &header, sizeof(header));
+
+	return new LogFile{fd, static_cast<char*>(data), 0, path};
+}
+
+void MatchRecorder::Close(LogFile* file)
+{
+	if(file == nullptr) return;
+
+	munmap(file->data, GetFileSize());
+	if(file->numRecords == 0)
+	{
+		unlink(file->path.c_str());
+	}
+	else
+	{
+		ftruncate(file->fd, sizeof(MatchLogHeader) + file->numRecords * sizeof(MatchRecord));
+	}
+	close(file->fd);
+	delete file;
+}
+
+// Keeps room for the file about to be prepared by deleting the oldest logs. The names start
+// with the date and time, so sorting them by name sorts them by age. Files that were prepared
+// but never used (e.g. the robot was turned off before the next match) are deleted too
+void MatchRecorder::DeleteOldLogs()
+{
+	DIR* directory = opendir(m_directory.c_str());
+	if(directory == nullptr) return;
+
+	std::vector<std::string> logs;
+	while(dirent* entry = readdir(directory))
+	{
+		std::string name = entry->d_name;
+		if(name.size() > 4 && name.compare(name.size() - 4, 4, ".bin") == 0)
+		{
+			logs.push_back(name);
+		}
+		else if(name.size() > 8 && name.compare(name.size() - 8, 8, ".bin.tmp") == 0)
+		{
+			unlink((m_directory + "/" + name).c_str());
+		}
+	}
+	closedir(directory);
+
+	std::sort(logs.begin(), logs.end());
+	for(int i = 0; i + m_maxFiles <= (int)logs.size(); i++)
+	{
+		unlink((m_directory + "/" + logs[i]).c_str());
+	}
+}
@@ -0,0 +1,55 @@
+#ifndef MATCH_RECORDER
+#define MATCH_RECORDER
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include "MatchRecord.h"
+
+// Writes MatchRecords into memory mapped log files, one file per match. The control thread calls
+// Record(), which only copies the record into the mapped file, so it never allocates, makes a
+// system call or waits on a lock. Everything slow is done from the main robot thread:
+// - Prepare() creates, sizes and maps the next file ahead of time, and deletes the oldest logs
+// - Rotate() names the prepared file and hands it to the recording thread, which switches to it
+//   at its next Record() and hands the finished file back
+// - Maintain() closes the finished file and truncates it to the records that were written
+// The pages of each file are faulted in when it's mapped, so writing a record doesn't page fault.
+// Records past the end of a file are dropped.
+class MatchRecorder
+{
+private:
+	struct LogFile
+	{
+		int fd;
+		char* data;
+		size_t numRecords;
+		std::string path;
+	};
+
+	std::string m_directory;
+	size_t m_maxRecords;
+	int m_maxFiles;
+	int m_numPrepared;
+
+	LogFile* m_next;                      // Main thread only
+	std::atomic<LogFile*> m_pending;      // Handed from the main thread to the recording thread
+	LogFile* m_current;                   // Recording thread only
+	std::atomic<LogFile*> m_retired;      // Handed from the recording thread back to the main thread
+
+	size_t GetFileSize();
+	LogFile* Open();
+	void Close(LogFile* file);
+	void DeleteOldLogs();
+
+public:
+	MatchRecorder(std::string directory, size_t maxRecords, int maxFiles);
+	virtual ~MatchRecorder();
+
+	void Prepare();
+	void Rotate(std::string name);
+	void Maintain();
+
+	void Record(const MatchRecord& record);
+};
+
+#endif
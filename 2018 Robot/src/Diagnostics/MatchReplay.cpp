@@ -0,0 +1,231 @@
+#include "MatchReplay.h"
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+	void ReplayController(const float* axes, uint16_t buttons, ControllerSnapshot& controller)
+	{
+		controller.leftX = axes[0];
+		controller.leftY = axes[1];
+		controller.rightX = axes[2];
+		controller.rightY = axes[3];
+		controller.leftTrigger = axes[4];
+		controller.rightTrigger = axes[5];
+
+		bool* pressed[] = {&controller.aButton, &controller.bButton, &controller.xButton, &controller.yButton,
+				&controller.leftBumper, &controller.rightBumper, &controller.backButton, &controller.startButton};
+		for(unsigned int i = 0; i < sizeof(pressed) / sizeof(pressed[0]); i++)
+		{
+			*pressed[i] = (buttons & (1 << i)) != 0;
+		}
+	}
+
+	bool IsLoopEnabled(const MatchRecord& record, RecordedLoop loop)
+	{
+		return (record.enabledLoops & (1 << loop)) != 0;
+	}
+
+	// Whether a Talon's command came from the robot logic rather than from one of the control loops
+	bool IsOpenLoop(const MatchRecord& record, int talon)
+	{
+		switch(talon)
+		{
+		case FRONT_LEFT_TALON:
+		case BACK_LEFT_TALON:
+		case FRONT_RIGHT_TALON:
+		case BACK_RIGHT_TALON:
+			return !IsLoopEnabled(record, ANGLE_LOOP) && !IsLoopEnabled(record, MAINTAIN_ANGLE_LOOP)
+					&& !IsLoopEnabled(record, DISTANCE_LOOP);
+		case RIGHT_ELEVATOR_TALON:
+		case LEFT_ELEVATOR_TALON:
+			return !IsLoopEnabled(record, ELEVATOR_LOOP);
+		default:
+			return true;
+		}
+	}
+}
+
+MatchReplay::MatchReplay() :
+	m_fd(-1),
+	m_data(nullptr),
+	m_size(0),
+	m_numRecords(0),
+	m_nextRecord(0),
+	m_numSteps(0),
+	m_numMismatches(0),
+	m_firstMismatchTime(-1),
+	m_maxCommandError(0),
+	m_maxSetpointError(0)
+{
+
+}
+
+MatchReplay::~MatchReplay()
+{
+	Close();
+}
+
+std::string MatchReplay::Open(const std::string& path)
+{
+	Close();
+
+	m_fd = open(path.c_str(), O_RDONLY);
+	if(m_fd < 0) return "Can't open " + path;
+
+	struct stat status;
+	if(fstat(m_fd, &status) != 0 || (size_t)status.st_size < sizeof(MatchLogHeader))
+	{
+		Close();
+		return path + " is too short to be a match log";
+	}
+	m_size = status.st_size;
+
+	void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+	if(data == MAP_FAILED)
+	{
+		m_data = nullptr;
+		Close();
+		return "Can't map " + path;
+	}
+	m_data = static_cast<const char*>(data);
+
+	MatchLogHeader header;
+	std::memcpy(&header, m_data, sizeof(header));
+	if(std::memcmp(header.magic, MATCH_LOG_MAGIC, sizeof(header.magic)) != 0
+			|| header.version != MATCH_LOG_VERSION || header.recordSize != sizeof(MatchRecord))
+	{
+		Close();
+		return path + " isn't a version " + std::to_string(MATCH_LOG_VERSION) + " match log";
+	}
+
+	// A log that wasn't closed properly is longer than its records, and one that was cut off
+	// in the middle of a write has fewer whole records than the header says
+	size_t wholeRecords = (m_size - sizeof(MatchLogHeader)) / sizeof(MatchRecord);
+	m_numRecords = header.numRecords < wholeRecords ? header.numRecords : wholeRecords;
+	m_nextRecord = 0;
+
+	m_numSteps = 0;
+	m_numMismatches = 0;
+	m_firstMismatchTime = -1;
+	m_maxCommandError = 0;
+	m_maxSetpointError = 0;
+	return "";
+}
+
+void MatchReplay::Close()
+{
+	if(m_data != nullptr) munmap(const_cast<char*>(m_data), m_size);
+	if(m_fd >= 0) close(m_fd);
+
+	m_fd = -1;
+	m_data = nullptr;
+	m_size = 0;
+	m_numRecords = 0;
+	m_nextRecord = 0;
+}
+
+bool MatchReplay::NextStep(RecordedMode mode, SensorSnapshot& snapshot, MatchRecord& expected)
+{
+	while(m_nextRecord < m_numRecords && GetRecord(m_nextRecord).robotMode != mode)
+	{
+		m_nextRecord++;
+	}
+	if(m_nextRecord >= m_numRecords) return false;
+
+	const MatchRecord& first = GetRecord(m_nextRecord);
+	size_t last = m_nextRecord;
+	while(last + 1 < m_numRecords && GetRecord(last + 1).robotMode == mode
+			&& GetRecord(last + 1).snapshotTimestamp == first.snapshotTimestamp)
+	{
+		last++;
+	}
+	m_nextRecord = last + 1;
+	expected = GetRecord(last);
+
+	snapshot.timestamp = first.snapshotTimestamp;
+	snapshot.elevatorHeight = first.elevatorHeight;
+	snapshot.elevatorVelocity = first.elevatorVelocity;
+	snapshot.elevatorAcceleration = 0;
+	snapshot.leftDriveDistance = first.leftDriveDistance;
+	snapshot.leftDriveVelocity = first.leftDriveVelocity;
+	snapshot.leftDriveAcceleration = 0;
+	snapshot.rightDriveDistance = first.rightDriveDistance;
+	snapshot.angle = first.angle;
+	snapshot.angularRate = first.angularRate;
+
+	snapshot.leftDriveCurrent = first.talonCurrents[FRONT_LEFT_TALON] + first.talonCurrents[BACK_LEFT_TALON];
+	snapshot.rightDriveCurrent = first.talonCurrents[FRONT_RIGHT_TALON] + first.talonCurrents[BACK_RIGHT_TALON];
+	snapshot.elevatorCurrent = first.talonCurrents[RIGHT_ELEVATOR_TALON] + first.talonCurrents[LEFT_ELEVATOR_TALON];
+	snapshot.intakeCurrent = first.talonCurrents[RIGHT_INTAKE_TALON] + first.talonCurrents[LEFT_INTAKE_TALON];
+
+	ReplayController(first.driveAxes, first.driveButtons, snapshot.driveController);
+	ReplayController(first.operatorAxes, first.operatorButtons, snapshot.operatorController);
+
+	m_numSteps++;
+	return true;
+}
+
+bool MatchReplay::Compare(const MatchRecord& expected, const MatchRecord& produced, double tolerance)
+{
+	double commandError = 0;
+	for(int i = 0; i < NUM_RECORDED_TALONS; i++)
+	{
+		if(!IsOpenLoop(expected, i)) continue;
+		commandError = std::fmax(commandError, std::fabs(expected.talonCommands[i] - produced.talonCommands[i]));
+	}
+
+	double setpointError = 0;
+	for(int i = 0; i < NUM_RECORDED_LOOPS; i++)
+	{
+		if(!IsLoopEnabled(expected, (RecordedLoop)i)) continue;
+		setpointError = std::fmax(setpointError, std::fabs(expected.loopSetpoints[i] - produced.loopSetpoints[i]));
+	}
+
+	m_maxCommandError = std::fmax(m_maxCommandError, commandError);
+	m_maxSetpointError = std::fmax(m_maxSetpointError, setpointError);
+
+	bool isMatch = commandError <= tolerance && setpointError <= tolerance
+			&& expected.enabledLoops == produced.enabledLoops;
+	if(!isMatch)
+	{
+		if(m_numMismatches == 0) m_firstMismatchTime = expected.snapshotTimestamp;
+		m_numMismatches++;
+	}
+	return isMatch;
+}
+
+int MatchReplay::GetNumSteps()
+{
+	return m_numSteps;
+}
+
+int MatchReplay::GetNumMismatches()
+{
+	return m_numMismatches;
+}
+
+double MatchReplay::GetFirstMismatchTime()
+{
+	return m_firstMismatchTime;
+}
+
+double MatchReplay::GetMaxCommandError()
+{
+	return m_maxCommandError;
+}
+
+double MatchReplay::GetMaxSetpointError()
+{
+	return m_maxSetpointError;
+}
+
+// The header is 24 bytes and the records are a multiple of 8, so every record is 8 byte aligned
+const MatchRecord& MatchReplay::GetRecord(size_t index)
+{
+	return *reinterpret_cast<const MatchRecord*>(m_data + sizeof(MatchLogHeader) + index * sizeof(MatchRecord));
+}
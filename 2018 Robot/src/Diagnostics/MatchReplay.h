@@ -0,0 +1,54 @@
+#ifndef MATCH_REPLAY
+#define MATCH_REPLAY
+
+#include <cstddef>
+#include <string>
+#include "MatchRecord.h"
+#include "../Sensors/SensorSnapshot.h"
+
+// Reads a log written by the MatchRecorder back one robot loop at a time, so that the robot logic
+// can be run again on the recorded sensor and controller values and its outputs compared to the
+// ones recorded in the match. It only depends on the log format, not on WPILib.
+// - A step is every record that came from the same SensorSnapshot. The step's snapshot is rebuilt
+//   from its records, and its last record holds the outputs the robot logic produced from it
+// - Compare() skips the Talons driven by a control loop that was enabled, since the loops close
+//   on the live sensors rather than the replayed ones
+class MatchReplay
+{
+private:
+	int m_fd;
+	const char* m_data;
+	size_t m_size;
+	size_t m_numRecords;
+	size_t m_nextRecord;
+
+	int m_numSteps;
+	int m_numMismatches;
+	double m_firstMismatchTime;
+	double m_maxCommandError;
+	double m_maxSetpointError;
+
+	const MatchRecord& GetRecord(size_t index);
+
+public:
+	MatchReplay();
+	virtual ~MatchReplay();
+
+	// Returns an error message, or an empty string if the log was opened
+	std::string Open(const std::string& path);
+	void Close();
+
+	// Returns false once there are no more steps recorded in the given RecordedMode
+	bool NextStep(RecordedMode mode, SensorSnapshot& snapshot, MatchRecord& expected);
+
+	// Returns false if the produced outputs don't match the expected ones within the tolerance
+	bool Compare(const MatchRecord& expected, const MatchRecord& produced, double tolerance);
+
+	int GetNumSteps();
+	int GetNumMismatches();
+	double GetFirstMismatchTime();   // Match log time in seconds, or -1 if everything matched
+	double GetMaxCommandError();
+	double GetMaxSetpointError();
+};
+
+#endif
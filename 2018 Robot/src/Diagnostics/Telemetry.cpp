@@ -0,0 +1,155 @@
+#include "Telemetry.h"
+#include "Tracer.h"
+#include <networktables/NetworkTableInstance.h>
+#include <chrono>
+
+constexpr int Telemetry::MAX_SLOTS;
+
+Telemetry::Telemetry(double publishPeriod) :
+	m_numSlots(0),
+	m_registerMutex(),
+	m_publishPeriod(publishPeriod),
+	m_table(),
+	m_thread(),
+	m_isRunning(false)
+{
+	for(int i = 0; i < MAX_SLOTS; i++)
+	{
+		m_slots[i].type = SlotType::NUMBER;
+		m_slots[i].number = 0;
+		m_slots[i].version = 0;
+		m_slots[i].hasPublished = false;
+		m_slots[i].publishedNumber = 0;
+		m_slots[i].publishedVersion = 0;
+	}
+}
+
+Telemetry::~Telemetry()
+{
+	m_isRunning = false;
+	if(m_thread.joinable())
+	{
+		m_thread.join();
+	}
+}
+
+void Telemetry::Start()
+{
+	if(m_isRunning) return;
+
+	m_isRunning = true;
+	m_thread = std::thread(&Telemetry::Run, this);
+}
+
+Telemetry::Slot Telemetry::AddNumber(const std::string& key)
+{
+	return Add(key, SlotType::NUMBER);
+}
+
+Telemetry::Slot Telemetry::AddBoolean(const std::string& key)
+{
+	return Add(key, SlotType::BOOLEAN);
+}
+
+Telemetry::Slot Telemetry::AddString(const std::string& key)
+{
+	return Add(key, SlotType::STRING);
+}
+
+void Telemetry::SetNumber(Slot slot, double value)
+{
+	if(slot < 0) return;
+	m_slots[slot].number.store(value, std::memory_order_relaxed);
+}
+
+void Telemetry::SetBoolean(Slot slot, bool value)
+{
+	if(slot < 0) return;
+	m_slots[slot].number.store(value ? 1 : 0, std::memory_order_relaxed);
+}
+
+void Telemetry::SetString(Slot slot, const std::string& value)
+{
+	if(slot < 0) return;
+	std::lock_guard<std::mutex> lock(m_slots[slot].textMutex);
+	m_slots[slot].text = value;
+	m_slots[slot].version++;
+}
+
+Telemetry::Slot Telemetry::Add(const std::string& key, SlotType type)
+{
+	std::lock_guard<std::mutex> lock(m_registerMutex);
+	int numSlots = m_numSlots.load();
+	for(int i = 0; i < numSlots; i++)
+	{
+		if(m_slots[i].key == key) return i;
+	}
+	if(numSlots >= MAX_SLOTS) return -1;
+
+	m_slots[numSlots].key = key;
+	m_slots[numSlots].type = type;
+
+	// The publisher only reads the slots below the count, so the slot is filled in before it's counted
+	m_numSlots.store(numSlots + 1, std::memory_order_release);
+	return numSlots;
+}
+
+void Telemetry::Run()
+{
+	auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(m_publishPeriod));
+	auto nextPublish = std::chrono::steady_clock::now();
+	m_table = nt::NetworkTableInstance::GetDefault().GetTable("SmartDashboard");
+	Tracer::GetInstance().SetThreadName("Telemetry");
+
+	while(m_isRunning)
+	{
+		{
+			ScopedTraceSpan span("Publish", "telemetry");
+			Publish();
+		}
+		nextPublish += period;
+		std::this_thread::sleep_until(nextPublish);
+	}
+}
+
+void Telemetry::Publish()
+{
+	int numSlots = m_numSlots.load(std::memory_order_acquire);
+	bool hasChanged = false;
+	for(int i = 0; i < numSlots; i++)
+	{
+		SlotData& slot = m_slots[i];
+		if(!slot.hasPublished) slot.entry = m_table->GetEntry(slot.key);
+
+		if(slot.type == SlotType::STRING)
+		{
+			unsigned int version = slot.version;
+			if(slot.hasPublished && version == slot.publishedVersion) continue;
+
+			std::string text;
+			{
+				std::lock_guard<std::mutex> lock(slot.textMutex);
+				text = slot.text;
+				version = slot.version;
+			}
+			slot.entry.SetString(text);
+			slot.publishedVersion = version;
+		}
+		else
+		{
+			double number = slot.number.load(std::memory_order_relaxed);
+			if(slot.hasPublished && number == slot.publishedNumber) continue;
+
+			if(slot.type == SlotType::BOOLEAN) slot.entry.SetBoolean(number != 0);
+			else                               slot.entry.SetDouble(number);
+			slot.publishedNumber = number;
+		}
+		slot.hasPublished = true;
+		hasChanged = true;
+	}
+	if(!hasChanged) return;
+
+	// Sends everything that changed in one update instead of waiting for the next NetworkTables tick
+	nt::NetworkTableInstance::GetDefault().Flush();
+}
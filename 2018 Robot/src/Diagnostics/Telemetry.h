@@ -0,0 +1,79 @@
+#ifndef TELEMETRY
+#define TELEMETRY
+
+#include <networktables/NetworkTable.h>
+#include <networktables/NetworkTableEntry.h>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Publishes values to the SmartDashboard table from a background thread so that the control
+// loops and periodic functions never touch NetworkTables themselves.
+// - Each value gets a slot registered once by key, usually in a constructor or RobotInit. Setting
+//   a number or boolean is a single atomic store, with no string handling or locking
+// - Strings take a short per-slot lock, so they should only be set from commands and not from loops
+// - Every publish period the thread sends the slots that changed since the last publish and
+//   flushes them to the dashboard as one batch
+class Telemetry
+{
+public:
+	typedef int Slot;   // A negative slot means it couldn't be registered, and setting it does nothing
+
+private:
+	enum class SlotType
+	{
+		NUMBER,
+		BOOLEAN,
+		STRING
+	};
+
+	struct SlotData
+	{
+		std::string key;
+		SlotType type;
+		std::atomic<double> number;          // Numbers, and booleans as 0 or 1
+		std::atomic<unsigned int> version;   // Bumped every time a string is set
+		std::string text;
+		std::mutex textMutex;
+
+		// Only used by the publisher thread
+		nt::NetworkTableEntry entry;
+		bool hasPublished;
+		double publishedNumber;
+		unsigned int publishedVersion;
+	};
+
+	static constexpr int MAX_SLOTS = 128;
+
+	SlotData m_slots[MAX_SLOTS];
+	std::atomic<int> m_numSlots;
+	std::mutex m_registerMutex;
+
+	double m_publishPeriod;
+	std::shared_ptr<nt::NetworkTable> m_table;
+	std::thread m_thread;
+	std::atomic<bool> m_isRunning;
+
+	Slot Add(const std::string& key, SlotType type);
+	void Run();
+	void Publish();
+
+public:
+	Telemetry(double publishPeriod);
+	virtual ~Telemetry();
+
+	void Start();
+
+	// Registering a key that already has a slot returns that slot
+	Slot AddNumber(const std::string& key);
+	Slot AddBoolean(const std::string& key);
+	Slot AddString(const std::string& key);
+
+	void SetNumber(Slot slot, double value);
+	void SetBoolean(Slot slot, bool value);
+	void SetString(Slot slot, const std::string& value);
+};
+
+#endif
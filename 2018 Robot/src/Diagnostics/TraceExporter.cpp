@@ -0,0 +1,79 @@
+#include "TraceExporter.h"
+#include "Tracer.h"
+#include "../Constants.h"
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+TraceExporter::TraceExporter(std::string directory, std::function<void(std::string)> onFailure) :
+	m_directory(directory),
+	m_onFailure(onFailure),
+	m_thread(),
+	m_mutex(),
+	m_hasRequest(),
+	m_fileNames(),
+	m_isRunning(false)
+{
+
+}
+
+TraceExporter::~TraceExporter()
+{
+	Stop();
+}
+
+void TraceExporter::Start()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if(m_isRunning) return;
+
+	m_isRunning = true;
+	m_thread = std::thread(&TraceExporter::Run, this);
+}
+
+void TraceExporter::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isRunning = false;
+	}
+	m_hasRequest.notify_all();
+	if(m_thread.joinable())
+	{
+		m_thread.join();
+	}
+}
+
+void TraceExporter::Export(std::string fileName)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_fileNames.push_back(fileName);
+	}
+	m_hasRequest.notify_all();
+}
+
+void TraceExporter::Run()
+{
+	// On Linux the niceness is per thread, so this only lowers the exporter below the main and
+	// telemetry threads. The control thread is real time and isn't affected either way
+	setpriority(PRIO_PROCESS, syscall(SYS_gettid), consts::TRACE_EXPORT_NICENESS);
+	Tracer::GetInstance().SetThreadName("Trace Export");
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while(true)
+	{
+		m_hasRequest.wait(lock, [this]() { return !m_isRunning || !m_fileNames.empty(); });
+		if(m_fileNames.empty()) return;
+
+		std::string path = m_directory + "/" + m_fileNames.front();
+		m_fileNames.pop_front();
+		lock.unlock();
+
+		mkdir(m_directory.c_str(), 0755);
+		if(!Tracer::GetInstance().Export(path)) m_onFailure(path);
+
+		lock.lock();
+	}
+}
@@ -0,0 +1,42 @@
+#ifndef TRACE_EXPORTER
+#define TRACE_EXPORTER
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Writes the Tracer's events to files from a low priority background thread, so a mode's Init
+// function only queues the export instead of waiting on the file system. The gap between auto
+// and teleop is shorter than an export can take on the roboRIO.
+// - Exports run in the order they were requested. Each file gets the events recorded up to when
+//   its export runs, so the start of the next mode may end up in the previous mode's file
+// - Files are written to directory, which is created by the first export
+// - onFailure is called from the exporter thread with the path that couldn't be written
+class TraceExporter
+{
+private:
+	std::string m_directory;
+	std::function<void(std::string)> m_onFailure;
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_hasRequest;
+	std::deque<std::string> m_fileNames;
+	bool m_isRunning;
+
+	void Run();
+
+public:
+	TraceExporter(std::string directory, std::function<void(std::string)> onFailure);
+	virtual ~TraceExporter();
+
+	void Start();
+	// Finishes the queued exports before the thread stops
+	void Stop();
+
+	void Export(std::string fileName);
+};
+
+#endif
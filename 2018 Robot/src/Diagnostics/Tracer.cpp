@@ -0,0 +1,168 @@
+#include "Tracer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+constexpr int Tracer::NAME_LENGTH;
+constexpr int Tracer::EVENTS_PER_THREAD;
+
+namespace
+{
+	void CopyName(char* destination, const char* name)
+	{
+		std::strncpy(destination, name, Tracer::NAME_LENGTH - 1);
+		destination[Tracer::NAME_LENGTH - 1] = '\0';
+	}
+
+	// Names are ours or come from the robot code, but a quote or backslash would still break the JSON
+	void WriteJsonString(FILE* file, const char* text)
+	{
+		std::fputc('"', file);
+		for(const char* c = text; *c != '\0'; c++)
+		{
+			if(*c == '"' || *c == '\\') std::fputc('\\', file);
+			if((unsigned char)*c >= ' ') std::fputc(*c, file);
+		}
+		std::fputc('"', file);
+	}
+}
+
+Tracer::Tracer() :
+	m_isEnabled(false),
+	m_buffers(),
+	m_buffersMutex()
+{
+
+}
+
+Tracer& Tracer::GetInstance()
+{
+	static Tracer instance;
+	return instance;
+}
+
+int64_t Tracer::GetMicros()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::SetEnabled(bool enabled)
+{
+	m_isEnabled = enabled;
+}
+
+bool Tracer::IsEnabled()
+{
+	return m_isEnabled.load(std::memory_order_relaxed);
+}
+
+void Tracer::SetThreadName(const char* name)
+{
+	CopyName(GetThreadBuffer().threadName, name);
+}
+
+void Tracer::AddSpan(const char* name, const char* category, int64_t startMicros, int64_t endMicros)
+{
+	if(!IsEnabled()) return;
+	Add(name, category, startMicros, endMicros - startMicros);
+}
+
+void Tracer::AddInstant(const char* name, const char* category)
+{
+	if(!IsEnabled()) return;
+	Add(name, category, GetMicros(), -1);
+}
+
+// Buffers are never freed, since threads like the Notifier's can outlive any owner of them
+Tracer::ThreadBuffer& Tracer::GetThreadBuffer()
+{
+	thread_local ThreadBuffer* buffer = nullptr;
+	if(buffer == nullptr)
+	{
+		buffer = new ThreadBuffer();
+		buffer->numEvents = 0;
+		buffer->numExported = 0;
+		buffer->threadName[0] = '\0';
+
+		std::lock_guard<std::mutex> lock(m_buffersMutex);
+		buffer->threadId = m_buffers.size() + 1;
+		m_buffers.push_back(buffer);
+	}
+	return *buffer;
+}
+
+void Tracer::Add(const char* name, const char* category, int64_t startMicros, int64_t durationMicros)
+{
+	ThreadBuffer& buffer = GetThreadBuffer();
+	uint64_t index = buffer.numEvents.load(std::memory_order_relaxed);
+
+	TraceEvent& event = buffer.events[index % EVENTS_PER_THREAD];
+	CopyName(event.name, name);
+	event.category = category;
+	event.startMicros = startMicros;
+	event.durationMicros = durationMicros;
+
+	// Export() only reads events below the count, so the event is written before it's counted
+	buffer.numEvents.store(index + 1, std::memory_order_release);
+}
+
+bool Tracer::Export(const std::string& path)
+{
+	FILE* file = std::fopen(path.c_str(), "w");
+	if(file == nullptr) return false;
+
+	std::vector<ThreadBuffer*> buffers;
+	{
+		std::lock_guard<std::mutex> lock(m_buffersMutex);
+		buffers = m_buffers;
+	}
+
+	std::fputs("{\"traceEvents\":[\n", file);
+	bool isFirst = true;
+	for(ThreadBuffer* buffer : buffers)
+	{
+		std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+				isFirst ? "" : ",\n", buffer->threadId);
+		WriteJsonString(file, buffer->threadName[0] != '\0' ? buffer->threadName : "Thread");
+		std::fputs("}}", file);
+		isFirst = false;
+
+		uint64_t numEvents = buffer->numEvents.load(std::memory_order_acquire);
+		uint64_t first = buffer->numExported;
+		if(numEvents - first > (uint64_t)EVENTS_PER_THREAD) first = numEvents - EVENTS_PER_THREAD;
+
+		for(uint64_t i = first; i < numEvents; i++)
+		{
+			TraceEvent event = buffer->events[i % EVENTS_PER_THREAD];
+
+			// The thread may have wrapped around and overwritten the event while it was copied
+			if(buffer->numEvents.load(std::memory_order_acquire) - i > (uint64_t)EVENTS_PER_THREAD) continue;
+
+			std::fputs(",\n{\"name\":", file);
+			WriteJsonString(file, event.name);
+			std::fprintf(file, ",\"cat\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%lld", event.category,
+					buffer->threadId, (long long)event.startMicros);
+			if(event.durationMicros >= 0) std::fprintf(file, ",\"ph\":\"X\",\"dur\":%lld}", (long long)event.durationMicros);
+			else                          std::fputs(",\"ph\":\"i\",\"s\":\"t\"}", file);
+		}
+		buffer->numExported = numEvents;
+	}
+	std::fputs("\n]}\n", file);
+
+	return std::fclose(file) == 0;
+}
+
+ScopedTraceSpan::ScopedTraceSpan(const char* name, const char* category) :
+	m_name(name),
+	m_category(category),
+	m_startMicros(Tracer::GetInstance().IsEnabled() ? Tracer::GetMicros() : 0)
+{
+
+}
+
+ScopedTraceSpan::~ScopedTraceSpan()
+{
+	// Spans started while the tracer was disabled aren't recorded
+	if(m_startMicros != 0) Tracer::GetInstance().AddSpan(m_name, m_category, m_startMicros, Tracer::GetMicros());
+}
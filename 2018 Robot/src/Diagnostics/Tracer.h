@@ -0,0 +1,78 @@
+#ifndef TRACER
+#define TRACER
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Records spans and instant events from every thread into per-thread ring buffers and exports
+// them as Chrome trace-event JSON (open it in chrome://tracing or ui.perfetto.dev).
+// - Each thread gets its own buffer the first time it records, so recording never takes a lock
+//   or allocates after that. A disabled tracer costs one atomic load per span
+// - Names are copied into the event (and cut to NAME_LENGTH), so they can be temporary strings.
+//   Categories aren't copied and must be string literals
+// - The newest EVENTS_PER_THREAD events of each thread are kept. Export() writes the events
+//   recorded since the last export, from one thread at a time while the others keep recording
+class Tracer
+{
+public:
+	static constexpr int NAME_LENGTH = 40;
+	static constexpr int EVENTS_PER_THREAD = 8192;
+
+private:
+	struct TraceEvent
+	{
+		char name[NAME_LENGTH];
+		const char* category;
+		int64_t startMicros;
+		int64_t durationMicros;   // Negative for an instant event
+	};
+
+	struct ThreadBuffer
+	{
+		std::array<TraceEvent, EVENTS_PER_THREAD> events;
+		std::atomic<uint64_t> numEvents;
+		uint64_t numExported;     // Only used by Export()
+		int threadId;
+		char threadName[NAME_LENGTH];
+	};
+
+	std::atomic<bool> m_isEnabled;
+	std::vector<ThreadBuffer*> m_buffers;
+	std::mutex m_buffersMutex;
+
+	Tracer();
+	ThreadBuffer& GetThreadBuffer();
+	void Add(const char* name, const char* category, int64_t startMicros, int64_t durationMicros);
+
+public:
+	static Tracer& GetInstance();
+	static int64_t GetMicros();
+
+	void SetEnabled(bool enabled);
+	bool IsEnabled();
+
+	void SetThreadName(const char* name);
+	void AddSpan(const char* name, const char* category, int64_t startMicros, int64_t endMicros);
+	void AddInstant(const char* name, const char* category);
+
+	bool Export(const std::string& path);
+};
+
+// Records a span for the scope it's declared in
+class ScopedTraceSpan
+{
+private:
+	const char* m_name;
+	const char* m_category;
+	int64_t m_startMicros;
+
+public:
+	ScopedTraceSpan(const char* name, const char* category);
+	~ScopedTraceSpan();
+};
+
+#endif
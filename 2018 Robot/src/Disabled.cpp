@@ -3,93 +3,74 @@
 void Robot::DisabledInit()
 {
 	StopCurrentProcesses();
+	m_robotMode = DISABLED_MODE;
+	ResetTiming(m_disabledTiming);
+	ExportTrace();
+
+	// Match log replay
+	m_dashboardControls.replayMatchLog.Reset();
+	if(!SmartDashboard::ContainsKey("Replay Log Path")) SmartDashboard::PutString("Replay Log Path", "");
 
 	// Autonomous Modes
-	SmartDashboard::PutBoolean("Test Angle", 0);
-	SmartDashboard::PutBoolean("Test Maintain", 0);
-	SmartDashboard::PutBoolean("Test Distance", 0);
+	m_dashboardControls.testAngle.Reset();
+	m_dashboardControls.testMaintain.Reset();
+	m_dashboardControls.testDistance.Reset();
 
 	// Sensor Resets
-	SmartDashboard::PutBoolean("Reset Angle", 0);
-	SmartDashboard::PutBoolean("Reset Encoders", 0);
+	m_dashboardControls.resetAngle.Reset();
+	m_dashboardControls.resetEncoders.Reset();
 
 	// Maintain Angle Test buttons/output
-	SmartDashboard::PutNumber("Test Maintain Output", 0);
-	SmartDashboard::PutBoolean("Enable Test Distance Output", 0);
-	SmartDashboard::PutBoolean("Enable Maintain Controller", 0);
-	SmartDashboard::PutBoolean("Toggle Maintain Test", 0);
+	m_dashboardControls.testMaintainOutput.Reset();
+	m_dashboardControls.enableTestDistanceOutput.Reset();
+	m_dashboardControls.enableMaintainController.Reset();
+	m_dashboardControls.toggleMaintainTest.Reset();
 
 	// Distance Tests
-	SmartDashboard::PutBoolean("Go Forward, Turn Right", 0);
-	SmartDashboard::PutBoolean("Toggle Distance Test", 0);
+	m_dashboardControls.goForwardTurnRight.Reset();
+	m_dashboardControls.toggleDistanceTest.Reset();
 
 	// Auto Elevator Tests
-	SmartDashboard::PutBoolean("Test Auto Elevator", 0);
-	SmartDashboard::PutNumber("Desired Increment", 0);
-	SmartDashboard::PutBoolean("Go to Increment", 0);
+	m_dashboardControls.testAutoElevator.Reset();
+	m_dashboardControls.desiredIncrement.Reset();
+	m_dashboardControls.goToIncrement.Reset();
 
 	// SmartDashboard code to toggle each teleop test function
-	SmartDashboard::PutBoolean("Drive", 0);
-	SmartDashboard::PutBoolean("Full Elevator", 0);
-	SmartDashboard::PutBoolean("Manual Elevator", 0);
-	SmartDashboard::PutBoolean("PID Elevator", 0);
-	SmartDashboard::PutBoolean("Intake", 0);
+	m_dashboardControls.driveTest.Reset();
+	m_dashboardControls.fullElevatorTest.Reset();
+	m_dashboardControls.manualElevatorTest.Reset();
+	m_dashboardControls.pidElevatorTest.Reset();
+	m_dashboardControls.intakeTest.Reset();
 
-	SmartDashboard::PutBoolean("Toggle Elevator Safety", 0);
+	m_dashboardControls.toggleElevatorSafety.Reset();
 }
 
 void Robot::DisabledPeriodic()
 {
-	std::string AutoCheck = "";
-
-	switch(AutoLocationChooser->GetSelected())
-	{
-	case consts::AutoPosition::LEFT_START:
-		AutoCheck += "Left";
-		break;
-	case consts::AutoPosition::RIGHT_START:
-		AutoCheck += "Right";
-		break;
-	case consts::AutoPosition::MIDDLE_START:
-		AutoCheck += "Middle";
-		break;
-	}
+	ScopedLoopTimer timing(m_disabledTiming);
+	UpdateSnapshot();
 
-	AutoCheck += ", ";
-
-	switch(AutoObjectiveChooser->GetSelected())
-	{
-	case consts::AutoObjective::BASELINE:
-		AutoCheck += "Baseline";
-		break;
-	case consts::AutoObjective::DEFAULT:
-		AutoCheck += "Default Path";
-		break;
-	case consts::AutoObjective::SCALE:
-		AutoCheck += "Scale";
-		break;
-	case consts::AutoObjective::SWITCH:
-		AutoCheck += "Switch";
-		break;
-	}
+	// Get the next match log ready while nothing is waiting on the main thread
+	m_matchRecorder.Prepare();
+	ReplayPeriodic();
 
-	AutoCheck += ", Switch Approach: ";
-
-	switch(SwitchApproachChooser->GetSelected())
-	{
-	case consts::SwitchApproach::FRONT:
-		AutoCheck += "Front";
-		break;
-	case consts::SwitchApproach::SIDE:
-		AutoCheck += "Side";
-		break;
-	}
-
-	SmartDashboard::PutString("Auto Settings", AutoCheck);
+	// Build the auto plans now so that auto can start the moment the game data arrives. This
+	// also republishes the auto settings when the selection changes
+	UpdateAutoPlans();
 }
 
 void Robot::StopCurrentProcesses()
 {
+	// Waits for a first auto step the GameDataListener may be running
+	std::lock_guard<std::mutex> autoStepLock(m_autoStepMutex);
+	// Enabling the robot stops a replay so it can't fight the real robot logic
+	if(m_isReplaying) FinishReplay();
+	m_gameDataListener.Disarm();
+	{
+		std::lock_guard<std::recursive_mutex> lock(m_autoPlanMutex);
+		m_isWaitingForGameData = false;
+	}
+	m_autoScheduler.Cancel();
 	ResetSensors();
 	DisablePIDControllers();
 	ZeroMotors();
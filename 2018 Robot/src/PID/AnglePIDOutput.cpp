@@ -1,11 +1,13 @@
 #include "AnglePIDOutput.h"
-#include "DistancePIDHelper.h"
+#include "../Robot.h"
 
-AnglePIDOutput::AnglePIDOutput(DifferentialDrive& driveTrain) :
-	m_driveTrain(driveTrain),
+AnglePIDOutput::AnglePIDOutput(DriveMixer& driveMixer, Telemetry& telemetry) :
+	m_driveMixer(driveMixer),
+	m_telemetry(telemetry),
+	m_outputSlot(telemetry.AddNumber("Angle PID Output")),
 	m_output(0),
-	m_distancePID(nullptr),
-	m_testDistOutput(0)
+	m_testDistOutput(0),
+	m_feedforward(0)
 {
 
 }
@@ -17,12 +19,13 @@ AnglePIDOutput::~AnglePIDOutput()
 
 void AnglePIDOutput::PIDWrite(double output)
 {
-	SmartDashboard::PutNumber("Angle PID Output", output);
+	m_telemetry.SetNumber(m_outputSlot, output);
+	output = limit(output + m_feedforward);
 
-	double drive = m_distancePID == nullptr ? 0 : m_distancePID->GetOutput();
-	if(m_testDistOutput != 0) drive = m_testDistOutput;
+	// The distance loop adds its own forward output to the mixer
+	if(m_testDistOutput != 0) m_driveMixer.AddForward(m_testDistOutput);
 
-	m_driveTrain.ArcadeDrive(drive, output, false);
+	m_driveMixer.AddTurn(output);
 	m_output = output;
 }
 
@@ -31,12 +34,12 @@ double AnglePIDOutput::GetOutput()
 	return m_output;
 }
 
-void AnglePIDOutput::SetDistancePID(DistancePIDHelper* distancePID)
+void AnglePIDOutput::SetTestDistOutput(double testDistOutput)
 {
-	m_distancePID = distancePID;
+	m_testDistOutput = testDistOutput;
 }
 
-void AnglePIDOutput::SetTestDistOutput(double testDistOutput)
+void AnglePIDOutput::SetFeedforward(double feedforward)
 {
-	m_testDistOutput = testDistOutput;
+	m_feedforward = feedforward;
 }
@@ -2,28 +2,30 @@
 #define ANGLE_PID_OUTPUT
 
 #include <WPILib.h>
+#include "../Control/DriveMixer.h"
+#include "../Diagnostics/Telemetry.h"
 
 using namespace frc;
 
-class DistancePIDHelper; //Forward declare the DistancePIDHelper class to avoid circular header dependencies
-
 class AnglePIDOutput : public PIDOutput
 {
 private:
-	DifferentialDrive& m_driveTrain;
+	DriveMixer& m_driveMixer;
+	Telemetry& m_telemetry;
+	Telemetry::Slot m_outputSlot;
 	double m_output;                  // Stores the motor output so that other classes can access it
-	DistancePIDHelper* m_distancePID;
 	double m_testDistOutput;
+	double m_feedforward;             // Added to the PID output while following a motion profile
 
 public:
-	AnglePIDOutput(DifferentialDrive& DriveTrain);
+	AnglePIDOutput(DriveMixer& driveMixer, Telemetry& telemetry);
 	virtual ~AnglePIDOutput();
 
 	void PIDWrite(double output) override;
 
 	double GetOutput();
-	void SetDistancePID(DistancePIDHelper* distancePID);
 	void SetTestDistOutput(double testDistOutput);
+	void SetFeedforward(double feedforward);
 };
 
 #endif
@@ -1,11 +1,13 @@
 #include "DistancePIDHelper.h"
 #include "../Robot.h"
 
-DistancePIDHelper::DistancePIDHelper(WPI_TalonSRX& motor, DifferentialDrive& driveTrain) :
+DistancePIDHelper::DistancePIDHelper(WPI_TalonSRX& motor, DriveMixer& driveMixer, Telemetry& telemetry) :
 	m_motor(motor),
-	m_DriveTrain(driveTrain),
+	m_driveMixer(driveMixer),
+	m_telemetry(telemetry),
+	m_outputSlot(telemetry.AddNumber("Distance PID Output")),
 	m_output(0),
-	m_AnglePID(nullptr)
+	m_feedforward(0)
 {
 
 }
@@ -20,12 +22,21 @@ double DistancePIDHelper::PIDGet()
 	return PulsesToInches(m_motor.GetSelectedSensorPosition(0));
 }
 
+// Returns the velocity in inches per second. The Talon reports it in pulses per 100ms
+double DistancePIDHelper::GetVelocity()
+{
+	units::InchesPerSecond velocity = units::Ticks(m_motor.GetSelectedSensorVelocity(0)) / units::TALON_VELOCITY_PERIOD
+			* consts::DRIVE_INCHES_PER_TICK;
+	return velocity.Value();
+}
+
 void DistancePIDHelper::PIDWrite(double output)
 {
-	SmartDashboard::PutNumber("Distance PID Output", output);
-	double angle = m_AnglePID == nullptr ? 0 : m_AnglePID->GetOutput();
+	m_telemetry.SetNumber(m_outputSlot, output);
+	output = limit(output + m_feedforward);
 
-	m_DriveTrain.ArcadeDrive(output, angle, false);
+	// The angle loop adds its own turning output to the mixer
+	m_driveMixer.AddForward(output);
 	m_output = output;
 }
 
@@ -34,7 +45,7 @@ double DistancePIDHelper::GetOutput()
 	return m_output;
 }
 
-void DistancePIDHelper::SetAnglePID(AnglePIDOutput* anglePID)
+void DistancePIDHelper::SetFeedforward(double feedforward)
 {
-	m_AnglePID = anglePID;
+	m_feedforward = feedforward;
 }
@@ -3,28 +3,31 @@
 
 #include <WPILib.h>
 #include <ctre/Phoenix.h>
+#include "../Control/DriveMixer.h"
+#include "../Diagnostics/Telemetry.h"
 
 using namespace frc;
 
-class AnglePIDOutput; //Forward declare the AnglePIDOutput class to avoid circular header dependencies
-
 class DistancePIDHelper : public PIDSource, public PIDOutput
 {
 private:
 	WPI_TalonSRX& m_motor;
-	DifferentialDrive& m_DriveTrain;
+	DriveMixer& m_driveMixer;
+	Telemetry& m_telemetry;
+	Telemetry::Slot m_outputSlot;
 	double m_output;                 // Stores the motor output so that other classes can access it
-	AnglePIDOutput* m_AnglePID;
+	double m_feedforward;            // Added to the PID output while following a motion profile
 
 public:
-	DistancePIDHelper(WPI_TalonSRX& motor, DifferentialDrive& driveTrain);
+	DistancePIDHelper(WPI_TalonSRX& motor, DriveMixer& driveMixer, Telemetry& telemetry);
 	virtual ~DistancePIDHelper();
 
 	double PIDGet() override;
 	void PIDWrite(double output) override;
 
 	double GetOutput();
-	void SetAnglePID(AnglePIDOutput* anglePID);
+	double GetVelocity();
+	void SetFeedforward(double feedforward);
 };
 
 #endif
@@ -1,10 +1,30 @@
 #include <PID/ElevatorPIDHelper.h>
+#include <PID/GainSchedule.h>
 #include <Robot.h>
 
-ElevatorPIDHelper::ElevatorPIDHelper(WPI_TalonSRX* TalonWithEncoder, WPI_TalonSRX* FollowerMotor) :
+namespace
+{
+	typedef GainSchedule<consts::NUM_ELEVATOR_GAIN_HEIGHTS, consts::NUM_ELEVATOR_GAINS> ElevatorGainSchedule;
+
+	constexpr ElevatorGainSchedule RISING_GAINS(consts::ELEVATOR_GAIN_HEIGHTS, consts::ELEVATOR_GAINS_RISING);
+	constexpr ElevatorGainSchedule LOWERING_GAINS(consts::ELEVATOR_GAIN_HEIGHTS, consts::ELEVATOR_GAINS_LOWERING);
+
+	static_assert(RISING_GAINS.IsValid() && LOWERING_GAINS.IsValid(), "ELEVATOR_GAIN_HEIGHTS must be increasing");
+}
+
+ElevatorPIDHelper::ElevatorPIDHelper(WPI_TalonSRX* TalonWithEncoder, WPI_TalonSRX* FollowerMotor, Telemetry& telemetry) :
 	m_TalonWithEncoder(TalonWithEncoder),
-	m_FollowerMotor(FollowerMotor)
+	m_FollowerMotor(FollowerMotor),
+	m_telemetry(telemetry),
+	m_heightSlot(telemetry.AddNumber("Elevator Height")),
+	m_outputSlot(telemetry.AddNumber("Elevator PID Output")),
+	m_referenceVelocity(0),
+	m_referenceAcceleration(0)
 {
+	for(int gain = 0; gain < consts::NUM_ELEVATOR_GAINS; gain++)
+	{
+		m_gains[gain] = RISING_GAINS.Get(gain, 0);
+	}
 
 }
 
@@ -16,22 +36,66 @@ ElevatorPIDHelper::~ElevatorPIDHelper()
 double ElevatorPIDHelper::PIDGet()
 {
 	double height = GetHeightInches();
-	SmartDashboard::PutNumber("Elevator Height", height);
+	m_telemetry.SetNumber(m_heightSlot, height);
 	return height;
 }
 
 double ElevatorPIDHelper::GetHeightInches()
 {
-	double circumference = m_DRUM_DIAMETER * consts::PI;
-	double revolutions = m_TalonWithEncoder->GetSelectedSensorPosition(0) / consts::PULSES_PER_REV;
-	double distance = revolutions * circumference;
+	return (units::Ticks(m_TalonWithEncoder->GetSelectedSensorPosition(0)) * consts::ELEVATOR_INCHES_PER_TICK).Value();
+}
+
+double ElevatorPIDHelper::GetPulsesPerInch()
+{
+	return (1 / consts::ELEVATOR_INCHES_PER_TICK).Value();
+}
 
-	return distance;
+// Returns the velocity in inches per second. The Talon reports it in pulses per 100ms
+double ElevatorPIDHelper::GetVelocityInches()
+{
+	units::InchesPerSecond velocity = units::Ticks(m_TalonWithEncoder->GetSelectedSensorVelocity(0))
+			/ units::TALON_VELOCITY_PERIOD * consts::ELEVATOR_INCHES_PER_TICK;
+	return velocity.Value();
 }
 
 void ElevatorPIDHelper::PIDWrite(double output)
 {
-	SmartDashboard::PutNumber("Elevator PID Output", output);
+	m_telemetry.SetNumber(m_outputSlot, output);
 	m_TalonWithEncoder->Set(output);
 	m_FollowerMotor->Set(output);
 }
+
+void ElevatorPIDHelper::SetReference(double velocity, double acceleration)
+{
+	m_referenceVelocity = velocity;
+	m_referenceAcceleration = acceleration;
+}
+
+// Looks up the gains for the given height, using the lowering table when the setpoint is below it.
+// The height is passed in so the schedule matches the reading the loop used, without another CAN read
+void ElevatorPIDHelper::UpdateGains(double setpoint, double height)
+{
+	const ElevatorGainSchedule& schedule = setpoint < height ? LOWERING_GAINS : RISING_GAINS;
+
+	for(int gain = 0; gain < consts::NUM_ELEVATOR_GAINS; gain++)
+	{
+		m_gains[gain] = schedule.Get(gain, height);
+	}
+}
+
+double ElevatorPIDHelper::GetGain(consts::ElevatorGain gain)
+{
+	return m_gains[gain];
+}
+
+// Motor output that holds the carriage up and moves it at the reference velocity and acceleration.
+// The friction term is only added in the direction of travel, so nothing fights it while holding
+double ElevatorPIDHelper::GetFeedforward()
+{
+	double friction = 0;
+	if(m_referenceVelocity > 0)      friction = m_gains[consts::ELEVATOR_KS];
+	else if(m_referenceVelocity < 0) friction = -m_gains[consts::ELEVATOR_KS];
+
+	return m_gains[consts::ELEVATOR_KG] + friction + m_gains[consts::ELEVATOR_KV] * m_referenceVelocity
+			+ m_gains[consts::ELEVATOR_KA] * m_referenceAcceleration;
+}
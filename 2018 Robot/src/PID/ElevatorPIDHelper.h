@@ -4,6 +4,7 @@
 #include <WPILib.h>
 #include <ctre/Phoenix.h>
 #include "../Constants.h"
+#include "../Diagnostics/Telemetry.h"
 
 using namespace frc;
 
@@ -12,14 +13,26 @@ class ElevatorPIDHelper : public PIDSource, public PIDOutput
 private:
 	WPI_TalonSRX* m_TalonWithEncoder;
 	WPI_TalonSRX* m_FollowerMotor;
-	static constexpr double m_DRUM_DIAMETER = 1.5;
+	Telemetry& m_telemetry;
+	Telemetry::Slot m_heightSlot;
+	Telemetry::Slot m_outputSlot;
+	double m_referenceVelocity;       // Velocity and acceleration the elevator should be moving at,
+	double m_referenceAcceleration;   // set while following a motion profile and 0 while holding
+	double m_gains[consts::NUM_ELEVATOR_GAINS]; // Scheduled for the current height and direction
 
 public:
-	ElevatorPIDHelper(WPI_TalonSRX* TalonWithEncoder, WPI_TalonSRX* FollowerMotor);
+	ElevatorPIDHelper(WPI_TalonSRX* TalonWithEncoder, WPI_TalonSRX* FollowerMotor, Telemetry& telemetry);
 	virtual ~ElevatorPIDHelper();
 	double PIDGet() override;
 	double GetHeightInches();
+	double GetVelocityInches();
+	static double GetPulsesPerInch();
 	void PIDWrite(double output) override;
+
+	void SetReference(double velocity, double acceleration);
+	void UpdateGains(double setpoint, double height);
+	double GetGain(consts::ElevatorGain gain);
+	double GetFeedforward();
 };
 
 #endif
@@ -0,0 +1,54 @@
+#ifndef GAIN_SCHEDULE
+#define GAIN_SCHEDULE
+
+// Table of controller gains indexed by a mechanism position, e.g. the elevator height.
+// Each row holds every gain at one position and positions in between are linearly
+// interpolated. Positions outside the table use the first or last row.
+// - The table is a reference to constexpr arrays, so a schedule can be built and
+//   checked with static_assert at compile time
+template<int NUM_POSITIONS, int NUM_GAINS>
+class GainSchedule
+{
+private:
+	const double (&m_positions)[NUM_POSITIONS];
+	const double (&m_gains)[NUM_POSITIONS][NUM_GAINS];
+
+public:
+	constexpr GainSchedule(const double (&positions)[NUM_POSITIONS], const double (&gains)[NUM_POSITIONS][NUM_GAINS]) :
+		m_positions(positions),
+		m_gains(gains)
+	{
+
+	}
+
+	// The interpolation below needs the positions to be strictly increasing
+	constexpr bool IsValid() const
+	{
+		for(int i = 1; i < NUM_POSITIONS; i++)
+		{
+			if(m_positions[i] <= m_positions[i - 1]) return false;
+		}
+		return NUM_POSITIONS > 0;
+	}
+
+	constexpr double Get(int gain, double position) const
+	{
+		if(position <= m_positions[0])
+		{
+			return m_gains[0][gain];
+		}
+
+		for(int i = 1; i < NUM_POSITIONS; i++)
+		{
+			if(position < m_positions[i])
+			{
+				double fraction = (position - m_positions[i - 1]) / (m_positions[i] - m_positions[i - 1]);
+				return m_gains[i - 1][gain] + fraction * (m_gains[i][gain] - m_gains[i - 1][gain]);
+			}
+		}
+
+		return m_gains[NUM_POSITIONS - 1][gain];
+	}
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include "MotionProfile.h"
+#include <cmath>
+
+MotionProfile::MotionProfile(double distance, double maxVelocity, double maxAcceleration, double maxJerk) :
+	m_direction(distance < 0 ? -1 : 1),
+	m_distance(std::fabs(distance)),
+	m_acceleration(maxAcceleration),
+	m_peakVelocity(0),
+	m_accelTime(0),
+	m_cruiseTime(0),
+	m_trapezoidTime(0),
+	m_smoothingTime(maxJerk > 0 ? maxAcceleration / maxJerk : 0)
+{
+	// Short moves never reach the max velocity and turn into a triangular profile
+	m_peakVelocity = std::fmin(maxVelocity, std::sqrt(m_distance * m_acceleration));
+	if(m_peakVelocity <= 0)
+	{
+		return;
+	}
+
+	m_accelTime = m_peakVelocity / m_acceleration;
+	double accelDistance = 0.5 * m_acceleration * m_accelTime * m_accelTime;
+	m_cruiseTime = (m_distance - 2 * accelDistance) / m_peakVelocity;
+	m_trapezoidTime = 2 * m_accelTime + m_cruiseTime;
+}
+
+double MotionProfile::TrapezoidVelocity(double t)
+{
+	if(t <= 0 || t >= m_trapezoidTime)       return 0;
+	else if(t < m_accelTime)                 return m_acceleration * t;
+	else if(t < m_accelTime + m_cruiseTime)  return m_peakVelocity;
+	else                                     return m_acceleration * (m_trapezoidTime - t);
+}
+
+double MotionProfile::TrapezoidPosition(double t)
+{
+	double accelDistance = 0.5 * m_acceleration * m_accelTime * m_accelTime;
+
+	if(t <= 0)
+	{
+		return 0;
+	}
+	else if(t < m_accelTime)
+	{
+		return 0.5 * m_acceleration * t * t;
+	}
+	else if(t < m_accelTime + m_cruiseTime)
+	{
+		return accelDistance + m_peakVelocity * (t - m_accelTime);
+	}
+	else if(t < m_trapezoidTime)
+	{
+		double timeLeft = m_trapezoidTime - t;
+		return m_distance - 0.5 * m_acceleration * timeLeft * timeLeft;
+	}
+	else
+	{
+		return m_distance;
+	}
+}
+
+double MotionProfile::TrapezoidPositionIntegral(double t)
+{
+	double accelDistance = 0.5 * m_acceleration * m_accelTime * m_accelTime;
+	double decelStart = m_accelTime + m_cruiseTime;
+
+	// Integral of the position at the end of the acceleration, cruise and deceleration phases
+	double accelIntegral = m_acceleration * m_accelTime * m_accelTime * m_accelTime / 6;
+	double cruiseIntegral = accelIntegral + accelDistance * m_cruiseTime
+			+ 0.5 * m_peakVelocity * m_cruiseTime * m_cruiseTime;
+	double decelIntegral = cruiseIntegral + m_distance * m_accelTime - accelIntegral;
+
+	if(t <= 0)
+	{
+		return 0;
+	}
+	else if(t < m_accelTime)
+	{
+		return m_acceleration * t * t * t / 6;
+	}
+	else if(t < decelStart)
+	{
+		double dt = t - m_accelTime;
+		return accelIntegral + accelDistance * dt + 0.5 * m_peakVelocity * dt * dt;
+	}
+	else if(t < m_trapezoidTime)
+	{
+		double timeLeft = m_trapezoidTime - t;
+		return cruiseIntegral + m_distance * (t - decelStart)
+				- m_acceleration * (m_accelTime * m_accelTime * m_accelTime - timeLeft * timeLeft * timeLeft) / 6;
+	}
+	else
+	{
+		return decelIntegral + m_distance * (t - m_trapezoidTime);
+	}
+}
+
+MotionState MotionProfile::Sample(double t)
+{
+	MotionState state;
+
+	if(m_smoothingTime > 0)
+	{
+		// Moving average of the trapezoid over the last m_smoothingTime seconds
+		double windowStart = t - m_smoothingTime;
+		state.position = (TrapezoidPositionIntegral(t) - TrapezoidPositionIntegral(windowStart)) / m_smoothingTime;
+		state.velocity = (TrapezoidPosition(t) - TrapezoidPosition(windowStart)) / m_smoothingTime;
+		state.acceleration = (TrapezoidVelocity(t) - TrapezoidVelocity(windowStart)) / m_smoothingTime;
+	}
+	else
+	{
+		double accel = 0;
+		if(t > 0 && t < m_accelTime) accel = m_acceleration;
+		else if(t >= m_accelTime + m_cruiseTime && t < m_trapezoidTime) accel = -m_acceleration;
+
+		state.position = TrapezoidPosition(t);
+		state.velocity = TrapezoidVelocity(t);
+		state.acceleration = accel;
+	}
+
+	state.position *= m_direction;
+	state.velocity *= m_direction;
+	state.acceleration *= m_direction;
+	return state;
+}
+
+double MotionProfile::GetDuration()
+{
+	return m_trapezoidTime + m_smoothingTime;
+}
+
+double MotionProfile::GetDistance()
+{
+	return m_direction * m_distance;
+}
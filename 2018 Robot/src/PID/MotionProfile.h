@@ -0,0 +1,43 @@
+#ifndef MOTION_PROFILE
+#define MOTION_PROFILE
+
+// Position, velocity and acceleration of a profile at one point in time
+struct MotionState
+{
+	double position;
+	double velocity;
+	double acceleration;
+};
+
+// Velocity and acceleration limited (trapezoidal) motion profile from 0 to a given distance.
+// If a max jerk is given, the trapezoid is smoothed with a moving average that is
+// maxAcceleration / maxJerk seconds long, which turns it into an S-curve that still
+// ends exactly at the distance and never exceeds the velocity or acceleration limits.
+// Moves too short to cruise can see up to twice the max jerk where the accel flips sign
+class MotionProfile
+{
+private:
+	double m_direction;       // 1 or -1 so that the math below only deals with positive distances
+	double m_distance;
+	double m_acceleration;
+	double m_peakVelocity;
+	double m_accelTime;
+	double m_cruiseTime;
+	double m_trapezoidTime;
+	double m_smoothingTime;   // 0 for a plain trapezoidal profile
+
+	// The trapezoidal profile and the integral of its position, which is
+	// what the S-curve smoothing is computed from
+	double TrapezoidVelocity(double t);
+	double TrapezoidPosition(double t);
+	double TrapezoidPositionIntegral(double t);
+
+public:
+	MotionProfile(double distance, double maxVelocity, double maxAcceleration, double maxJerk = 0);
+
+	MotionState Sample(double t);
+	double GetDuration();
+	double GetDistance();
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include "RelayAutotuner.h"
+#include "../Constants.h"
+#include <cmath>
+
+RelayAutotuner::RelayAutotuner() :
+	m_setpoint(0),
+	m_amplitude(0),
+	m_hysteresis(0),
+	m_bias(0),
+	m_cyclesToMeasure(0),
+	m_time(0),
+	m_relayOutput(0),
+	m_cycleCount(0),
+	m_cycleStartTime(0),
+	m_cycleMax(0),
+	m_cycleMin(0),
+	m_periodSum(0),
+	m_peakToPeakSum(0),
+	m_isFinished(false)
+{
+
+}
+
+RelayAutotuner::~RelayAutotuner()
+{
+
+}
+
+void RelayAutotuner::Start(double setpoint, double amplitude, double hysteresis, int cyclesToMeasure, double bias)
+{
+	m_setpoint = setpoint;
+	m_amplitude = amplitude;
+	m_hysteresis = hysteresis;
+	m_bias = bias;
+	m_cyclesToMeasure = cyclesToMeasure;
+
+	m_time = 0;
+	m_relayOutput = amplitude;
+	m_cycleCount = 0;
+	m_cycleStartTime = 0;
+	m_cycleMax = setpoint;
+	m_cycleMin = setpoint;
+	m_periodSum = 0;
+	m_peakToPeakSum = 0;
+	m_isFinished = false;
+}
+
+double RelayAutotuner::Update(double input, double dt)
+{
+	if(m_isFinished) return m_bias;
+	m_time += dt;
+
+	m_cycleMax = std::fmax(m_cycleMax, input);
+	m_cycleMin = std::fmin(m_cycleMin, input);
+
+	double error = m_setpoint - input;
+	if(error < -m_hysteresis && m_relayOutput > 0)
+	{
+		m_relayOutput = -m_amplitude;
+	}
+	else if(error > m_hysteresis && m_relayOutput < 0)
+	{
+		// A new cycle starts every time the relay switches back to pushing up
+		m_relayOutput = m_amplitude;
+		if(m_cycleCount > 0)
+		{
+			m_periodSum += m_time - m_cycleStartTime;
+			m_peakToPeakSum += m_cycleMax - m_cycleMin;
+		}
+		m_cycleCount++;
+		m_cycleStartTime = m_time;
+		m_cycleMax = input;
+		m_cycleMin = input;
+
+		if(GetMeasuredCycles() >= m_cyclesToMeasure)
+		{
+			m_isFinished = true;
+			return m_bias;
+		}
+	}
+
+	return m_bias + m_relayOutput;
+}
+
+bool RelayAutotuner::IsFinished()
+{
+	return m_isFinished;
+}
+
+int RelayAutotuner::GetMeasuredCycles()
+{
+	return m_cycleCount > 1 ? m_cycleCount - 1 : 0;
+}
+
+// Ku = 4d / (pi * a), where a is corrected for the hysteresis band
+double RelayAutotuner::GetUltimateGain()
+{
+	int cycles = GetMeasuredCycles();
+	if(cycles == 0) return 0;
+
+	double oscillation = m_peakToPeakSum / cycles / 2;
+	double effectiveAmplitude = std::sqrt(std::fmax(oscillation * oscillation - m_hysteresis * m_hysteresis, 0));
+	if(effectiveAmplitude <= 0) return 0;
+
+	return 4 * m_amplitude / (consts::PI * effectiveAmplitude);
+}
+
+double RelayAutotuner::GetUltimatePeriod()
+{
+	int cycles = GetMeasuredCycles();
+	return cycles == 0 ? 0 : m_periodSum / cycles;
+}
+
+// The drive, turn and elevator all behave like an integrator with a delay, K * e^(-Ls) / s.
+// At the ultimate frequency the delay adds the last 90 degrees of phase lag, so L = Tu / 4 and
+// K = wu / Ku. The gains then come from the SIMC rules for integrating plants with a closed loop
+// time constant of a quarter of the settle time, which can't be faster than the delay
+PIDGains RelayAutotuner::ProposeGains(double settleTime)
+{
+	PIDGains gains = {0, 0, 0};
+	double ultimateGain = GetUltimateGain();
+	double ultimatePeriod = GetUltimatePeriod();
+	if(ultimateGain <= 0 || ultimatePeriod <= 0) return gains;
+
+	double ultimateFrequency = 2 * consts::PI / ultimatePeriod;
+	double delay = ultimatePeriod / 4;
+	double plantGain = ultimateFrequency / ultimateGain;
+	double timeConstant = std::fmax(settleTime / 4, delay);
+
+	gains.p = 1 / (plantGain * (timeConstant + delay));
+	double integralTime = 4 * (timeConstant + delay);
+	gains.i = gains.p / integralTime * consts::PID_GAIN_PERIOD_S;
+	gains.d = 0;
+	return gains;
+}
@@ -0,0 +1,50 @@
+#ifndef RELAY_AUTOTUNER
+#define RELAY_AUTOTUNER
+
+// Gains in the units ControlLoop uses (tuned with a 50ms period)
+struct PIDGains
+{
+	double p;
+	double i;
+	double d;
+};
+
+// Relay feedback autotuner (Astrom-Hagglund). The loop output is switched between +/- the relay
+// amplitude around a bias whenever the error crosses the hysteresis band, which makes the
+// mechanism oscillate around the setpoint. The period and amplitude of that oscillation give the
+// ultimate gain and period, which the gains are proposed from.
+// - It has no WPILib dependencies, so it can be driven by a simulated plant as well as the robot
+class RelayAutotuner
+{
+private:
+	double m_setpoint;
+	double m_amplitude;
+	double m_hysteresis;
+	double m_bias;
+	int m_cyclesToMeasure;
+
+	double m_time;
+	double m_relayOutput;
+	int m_cycleCount;          // Rising edges seen so far. The first cycle is skipped as a transient
+	double m_cycleStartTime;
+	double m_cycleMax;
+	double m_cycleMin;
+	double m_periodSum;
+	double m_peakToPeakSum;
+	bool m_isFinished;
+
+public:
+	RelayAutotuner();
+	virtual ~RelayAutotuner();
+
+	void Start(double setpoint, double amplitude, double hysteresis, int cyclesToMeasure, double bias = 0);
+	double Update(double input, double dt);   // Returns the output to send to the mechanism
+
+	bool IsFinished();
+	int GetMeasuredCycles();
+	double GetUltimateGain();
+	double GetUltimatePeriod();
+	PIDGains ProposeGains(double settleTime);
+};
+
+#endif
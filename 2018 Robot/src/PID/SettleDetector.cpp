@@ -0,0 +1,64 @@
+#include "SettleDetector.h"
+#include <cmath>
+
+const char* SegmentResultName(SegmentResult result)
+{
+	switch(result)
+	{
+	case SegmentResult::SETTLED:
+		return "Settled";
+	case SegmentResult::STALLED:
+		return "Stalled";
+	case SegmentResult::TIMED_OUT:
+		return "Timed Out";
+	case SegmentResult::CANCELLED:
+		return "Cancelled";
+	case SegmentResult::IN_PROGRESS:
+	default:
+		return "In Progress";
+	}
+}
+
+SettleDetector::SettleDetector(double errorTolerance, double velocityTolerance, double dwellTime, double stallTime) :
+	m_errorTolerance(errorTolerance),
+	m_velocityTolerance(velocityTolerance),
+	m_dwellTime(dwellTime),
+	m_stallTime(stallTime),
+	m_timeInTolerance(0),
+	m_timeStopped(0),
+	m_prevError(0),
+	m_hasPrevError(false)
+{
+
+}
+
+void SettleDetector::Reset()
+{
+	m_timeInTolerance = 0;
+	m_timeStopped = 0;
+	m_hasPrevError = false;
+}
+
+void SettleDetector::Update(double error, double velocity, double dt)
+{
+	// The error rate also catches a setpoint that is still moving while the mechanism isn't
+	double errorRate = (m_hasPrevError && dt > 0) ? (error - m_prevError) / dt : 0;
+	m_prevError = error;
+	m_hasPrevError = true;
+
+	bool isStopped = std::fabs(velocity) <= m_velocityTolerance && std::fabs(errorRate) <= m_velocityTolerance;
+	bool isOnTarget = std::fabs(error) <= m_errorTolerance;
+
+	m_timeInTolerance = (isOnTarget && isStopped) ? m_timeInTolerance + dt : 0;
+	m_timeStopped = (!isOnTarget && isStopped) ? m_timeStopped + dt : 0;
+}
+
+bool SettleDetector::IsSettled()
+{
+	return m_timeInTolerance >= m_dwellTime;
+}
+
+bool SettleDetector::IsStalled()
+{
+	return m_timeStopped >= m_stallTime;
+}
@@ -0,0 +1,43 @@
+#ifndef SETTLE_DETECTOR
+#define SETTLE_DETECTOR
+
+// Why a closed loop segment ended
+enum class SegmentResult
+{
+	IN_PROGRESS,
+	SETTLED,
+	STALLED,
+	TIMED_OUT,
+	CANCELLED
+};
+
+const char* SegmentResultName(SegmentResult result);
+
+// Decides when a loop has settled from its error, the rate of change of its error and the
+// measured velocity of the mechanism. The loop counts as settled once all three have stayed
+// inside their tolerances for the dwell time, and as stalled once the mechanism has stopped
+// moving outside of the error tolerance for the stall time (e.g. pushed up against the switch)
+class SettleDetector
+{
+private:
+	double m_errorTolerance;
+	double m_velocityTolerance;
+	double m_dwellTime;
+	double m_stallTime;
+
+	double m_timeInTolerance;
+	double m_timeStopped;
+	double m_prevError;
+	bool m_hasPrevError;
+
+public:
+	SettleDetector(double errorTolerance, double velocityTolerance, double dwellTime, double stallTime);
+
+	void Reset();
+	void Update(double error, double velocity, double dt);
+
+	bool IsSettled();
+	bool IsStalled();
+};
+
+#endif
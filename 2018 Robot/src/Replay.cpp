@@ -0,0 +1,84 @@
+#include "Robot.h"
+
+// Runs the teleop logic again on a match log while the robot is disabled, and compares the
+// motor commands and loop setpoints it produces to the ones recorded in the match. Start it by
+// setting "Replay Log Path" to a log on the roboRIO and pressing "Replay Match Log".
+// - Only the teleop part of the log is replayed. Autonomous depends on elapsed time and on
+//   loops closing on the live sensors, so it can't be reproduced from the log
+// - The Talons don't move while the robot is disabled, so the commands only go to their caches
+// - It only runs on the roboRIO. The teleop logic sends its commands straight to the Talons,
+//   solenoids and control loops, so running it on a laptop would need an interface in front of
+//   all of them. MatchReplay itself doesn't depend on WPILib, so a host runner can reuse it
+void Robot::ReplayPeriodic()
+{
+	if(!m_isReplaying)
+	{
+		if(m_dashboardControls.replayMatchLog.Get())
+		{
+			m_dashboardControls.replayMatchLog.Set(false);
+			StartReplay(SmartDashboard::GetString("Replay Log Path", ""));
+		}
+		return;
+	}
+
+	for(int i = 0; i < consts::REPLAY_STEPS_PER_LOOP; i++)
+	{
+		SensorSnapshot snapshot;
+		MatchRecord expected;
+		if(!m_matchReplay.NextStep(TELEOP_MODE, snapshot, expected))
+		{
+			FinishReplay();
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_snapshotMutex);
+			m_snapshot = snapshot;
+		}
+		TeleopLogic();
+
+		MatchRecord produced;
+		FillMatchRecord(produced, snapshot);
+		if(!m_matchReplay.Compare(expected, produced, consts::REPLAY_TOLERANCE) && m_matchReplay.GetNumMismatches() == 1)
+		{
+			DriverStation::ReportWarning("Replay output differs from the match at " + std::to_string(snapshot.timestamp) + "s");
+		}
+	}
+}
+
+void Robot::StartReplay(std::string path)
+{
+	std::string error = m_matchReplay.Open(path);
+	if(!error.empty())
+	{
+		DriverStation::ReportError(error);
+		return;
+	}
+
+	// Start from the state TeleopInit leaves the robot in, without zeroing the real sensors
+	DisablePIDControllers();
+	ZeroMotors();
+	m_isElevatorLowering = false;
+	m_isElevatorInAutoMode = false;
+	m_targetElevatorStep = 0;
+	m_prevOperatorController = ControllerSnapshot();
+	m_robotMode = TELEOP_MODE;
+	m_isReplaying = true;
+	SmartDashboard::PutString("Replay Status", "Replaying " + path);
+}
+
+void Robot::FinishReplay()
+{
+	DisablePIDControllers();
+	ZeroMotors();
+	m_robotMode = DISABLED_MODE;
+	m_isReplaying = false;
+
+	SmartDashboard::PutNumber("Replay Steps", m_matchReplay.GetNumSteps());
+	SmartDashboard::PutNumber("Replay Mismatches", m_matchReplay.GetNumMismatches());
+	SmartDashboard::PutNumber("Replay First Mismatch (s)", m_matchReplay.GetFirstMismatchTime());
+	SmartDashboard::PutNumber("Replay Max Command Error", m_matchReplay.GetMaxCommandError());
+	SmartDashboard::PutNumber("Replay Max Setpoint Error", m_matchReplay.GetMaxSetpointError());
+	SmartDashboard::PutString("Replay Status", m_matchReplay.GetNumMismatches() == 0 ? "Matched" : "Differs");
+	m_matchReplay.Close();
+}
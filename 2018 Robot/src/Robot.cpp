@@ -1,6 +1,28 @@
 #include "Robot.h"
+#include <cstring>
+
+// Copies a controller's axes and packs its buttons into bits, in the order of ControllerSnapshot
+static void RecordController(const ControllerSnapshot& controller, float* axes, uint16_t& buttons)
+{
+	axes[0] = controller.leftX;
+	axes[1] = controller.leftY;
+	axes[2] = controller.rightX;
+	axes[3] = controller.rightY;
+	axes[4] = controller.leftTrigger;
+	axes[5] = controller.rightTrigger;
+
+	bool pressed[] = {controller.aButton, controller.bButton, controller.xButton, controller.yButton,
+			controller.leftBumper, controller.rightBumper, controller.backButton, controller.startButton};
+	buttons = 0;
+	for(unsigned int i = 0; i < sizeof(pressed) / sizeof(pressed[0]); i++)
+	{
+		if(pressed[i]) buttons |= 1 << i;
+	}
+}
 
 Robot::Robot() :
+	m_telemetry(consts::TELEMETRY_PUBLISH_PERIOD_S),
+
 	BackRightMotor(1),
 	FrontRightMotor(2),
 	FrontLeftMotor(3),
@@ -13,6 +35,7 @@ Robot::Robot() :
 	LeftMotors(FrontLeftMotor, BackLeftMotor),
 	RightMotors(FrontRightMotor, BackRightMotor),
 	DriveTrain(LeftMotors, RightMotors),
+	m_driveMixer(DriveTrain),
 	DriveController(0),
 	OperatorController(1),
 	AngleSensors(SPI::Port::kMXP, SPI::kOnboardCS0),
@@ -20,32 +43,75 @@ Robot::Robot() :
 	LeftSolenoid(1, 0),
 	RightSolenoid(3, 2),
 
-	ElevatorPID(&RightElevatorMotor, &LeftElevatorMotor),
-	AnglePIDOut(DriveTrain),
-	DistancePID(FrontLeftMotor, DriveTrain),
+	ElevatorPID(&RightElevatorMotor, &LeftElevatorMotor, m_telemetry),
+	AnglePIDOut(m_driveMixer, m_telemetry),
+	DistancePID(FrontLeftMotor, m_driveMixer, m_telemetry),
 	AngleController(0.04, 0, 0.04, AngleSensors, AnglePIDOut), //(0.02525, 0, 0.025)
 	MaintainAngleController(0.04, 0.0, 0.0, AngleSensors, AnglePIDOut), //(0.03, 0.0015, 0.06)
 	DistanceController(0.03, 0, 0.06, DistancePID, DistancePID), //(0.04, 0, 0)
-	ElevatorPIDController(0.25, 0., 0., ElevatorPID, ElevatorPID),
+	ElevatorPIDController(consts::ELEVATOR_GAINS_RISING[0][consts::ELEVATOR_P], 0., 0., ElevatorPID, ElevatorPID),
+	m_elevatorMotionMagic(RightElevatorMotor, &LeftElevatorMotor, ElevatorPIDHelper::GetPulsesPerInch()),
+	m_canBandwidth(),
+	m_matchRecorder(consts::MATCH_LOG_DIRECTORY, consts::MATCH_LOG_MAX_RECORDS, consts::MATCH_LOG_MAX_FILES),
+	m_recordedSnapshot(),
+	m_robotMode(DISABLED_MODE),
+	m_matchReplay(),
+	m_isReplaying(false),
+	m_traceName(),
+	m_numTraces(0),
+	m_traceExporter(consts::TRACE_DIRECTORY, [](std::string path) { DriverStation::ReportWarning("Couldn't write trace " + path); }),
+	m_controlExecutor(consts::CONTROL_PERIOD_S),
+	m_autoScheduler(),
+	m_baselinePlan(nullptr),
+	m_areAutoPlansReady(false),
+	m_plannedPosition(consts::AutoPosition::MIDDLE_START),
+	m_plannedObjective(consts::AutoObjective::DEFAULT),
+	m_plannedApproach(consts::SwitchApproach::FRONT),
+	m_plannedDelay(0),
+	m_isWaitingForGameData(false),
+	m_gameDataTimer(),
+	m_autoPlanMutex(),
+	m_autoStepMutex(),
+	m_gameDataListener([this](std::string gameData) { OnGameData(gameData); },
+			[](double timeout) { return DriverStation::GetInstance().WaitForData(timeout); },
+			[]() { return DriverStation::GetInstance().GetGameSpecificMessage(); }),
+	m_autotunedLoop(nullptr),
+	m_autotunedGains({0, 0, 0}),
+	m_snapshot(),
+	m_snapshotMutex(),
+	m_elevatorVelocity(consts::VELOCITY_ESTIMATOR_ALPHA, consts::MEASURED_VELOCITY_WEIGHT,
+			consts::ELEVATOR_MAX_SENSOR_VELOCITY, consts::VELOCITY_ESTIMATOR_MAX_SAMPLE_PERIOD_S),
+	m_leftDriveVelocity(consts::VELOCITY_ESTIMATOR_ALPHA, consts::MEASURED_VELOCITY_WEIGHT,
+			consts::DRIVE_MAX_SENSOR_VELOCITY, consts::VELOCITY_ESTIMATOR_MAX_SAMPLE_PERIOD_S),
 	m_isElevatorLowering(false),
 	m_isElevatorInAutoMode(false),
 	m_targetElevatorStep(0),
-	EjectTimer()
+	m_prevOperatorController(),
+	EjectTimer(),
+	m_disabledTiming("Disabled Periodic", consts::ROBOT_PERIOD_S),
+	m_autonomousTiming("Autonomous Periodic", consts::ROBOT_PERIOD_S),
+	m_teleopTiming("Teleop Periodic", consts::ROBOT_PERIOD_S),
+	m_testTiming("Test Periodic", consts::ROBOT_PERIOD_S),
+	m_timingPublishTimer(),
+	m_telemetrySlots(),
+	m_dashboardControls()
 {
-	AutoLocationChooser = new SendableChooser<consts::AutoPosition>();
-	AutoObjectiveChooser = new SendableChooser<consts::AutoObjective>();
-	SwitchApproachChooser = new SendableChooser<consts::SwitchApproach>();
+	RegisterTelemetry();
 }
 
 Robot::~Robot()
 {
-	delete AutoLocationChooser;
-	delete AutoObjectiveChooser;
-	delete SwitchApproachChooser;
+	// Stop the background threads before the members they use are destroyed. The control
+	// thread's output stages use the snapshot, the recorder state and the loops
+	m_controlExecutor.Stop();
+	m_gameDataListener.Stop();
+	m_traceExporter.Stop();
 }
 
 void Robot::RobotInit()
 {
+	Tracer::GetInstance().SetThreadName("Main");
+	Tracer::GetInstance().SetEnabled(consts::TRACING_ENABLED);
 	StopCurrentProcesses();
 	RightElevatorMotor.SetSelectedSensorPosition(0, consts::PID_LOOP_ID, consts::TALON_TIMEOUT_MS);
 	RightElevatorMotor.SetNeutralMode(Brake);
@@ -92,7 +158,7 @@ void Robot::RobotInit()
 	LiveWindow::GetInstance()->Add(&DistanceController);
 
 	// Configuring Angle PID Controller
-	AngleController.SetAbsoluteTolerance(1);
+	AngleController.SetAbsoluteTolerance(consts::TURN_SETTLE_TOLERANCE);
 	AngleController.SetOutputRange(-0.3, 0.3);
 
 	// Configuring Maintain Angle PID Controller
@@ -100,31 +166,269 @@ void Robot::RobotInit()
 	MaintainAngleController.SetOutputRange(-1.0, 1.0);
 
 	// Configuring Distance PID Controller
-	DistanceController.SetAbsoluteTolerance(3.5);
-	DistanceController.SetOutputRange(-0.7, 0.7);
+	DistanceController.SetAbsoluteTolerance(consts::DRIVE_SETTLE_TOLERANCE);
+	DistanceController.SetOutputRange(-consts::DISTANCE_PID_MAX_OUTPUT, consts::DISTANCE_PID_MAX_OUTPUT);
+
+	// Configuring Elevator PID Controller
+	ElevatorPIDController.SetAbsoluteTolerance(consts::ELEVATOR_PID_DEADBAND);
+	ElevatorPIDController.SetFeedforward([this]() { return ElevatorPID.GetFeedforward(); });
+
+	// Let the right elevator Talon close the loop itself, with the left one following it.
+	// The scheduled gravity feedforward is still sent along with each target
+	if(consts::ELEVATOR_ONBOARD_LOOP)
+	{
+		m_elevatorMotionMagic.Configure(consts::ELEVATOR_ONBOARD_P, consts::ELEVATOR_ONBOARD_D,
+				consts::ELEVATOR_GAINS_RISING[0][consts::ELEVATOR_KV],
+				consts::ELEVATOR_MAX_VELOCITY, consts::ELEVATOR_MAX_ACCELERATION);
+		ElevatorPIDController.SetOnboardController([this](double setpoint) {
+			m_elevatorMotionMagic.SetTarget(setpoint, ElevatorPID.GetGain(consts::ELEVATOR_KG));
+		});
+	}
+
+	// Only ask the Talons for the status frames the code reads. The currents of every motor
+	// but the linkage go into the SensorSnapshot, and only the encoders feed control loops
+	m_canBandwidth.Add(FrontLeftMotor, TalonUsage::ENCODER, &DistanceController);
+	m_canBandwidth.Add(FrontRightMotor, TalonUsage::ENCODER);
+	m_canBandwidth.Add(BackLeftMotor, TalonUsage::CURRENT_MONITORED);
+	m_canBandwidth.Add(BackRightMotor, TalonUsage::CURRENT_MONITORED);
+	m_canBandwidth.Add(RightElevatorMotor, consts::ELEVATOR_ONBOARD_LOOP ? TalonUsage::ONBOARD_LOOP : TalonUsage::ENCODER,
+			&ElevatorPIDController);
+	m_canBandwidth.Add(LeftElevatorMotor, TalonUsage::CURRENT_MONITORED);
+	m_canBandwidth.Add(RightIntakeMotor, TalonUsage::CURRENT_MONITORED);
+	m_canBandwidth.Add(LeftIntakeMotor, TalonUsage::CURRENT_MONITORED);
+	m_canBandwidth.Add(LinkageMotor, TalonUsage::MOTOR_ONLY);
+	m_canBandwidth.Apply();
+	SmartDashboard::PutNumber("CAN Utilization Estimate", m_canBandwidth.GetEstimatedUtilization() * 100);
+
+	// Start waiting for the driver station packets that carry the game data
+	m_gameDataListener.Start();
+
+	// Run the control loops in a fixed order and then send the combined drive output once
+	m_controlExecutor.Add(&AngleController, "Angle");
+	m_controlExecutor.Add(&MaintainAngleController, "Maintain Angle");
+	m_controlExecutor.Add(&DistanceController, "Distance");
+	m_controlExecutor.Add(&ElevatorPIDController, "Elevator");
+	m_controlExecutor.AddOutputStage([this]() { m_driveMixer.Commit(); });
+	// Speed up the feedback from encoders whose loops were just enabled
+	m_controlExecutor.AddOutputStage([this]() { m_canBandwidth.Update(); });
+	// Schedule the elevator gains for the next tick from the height the loop read this tick. The
+	// encoder isn't read while the loop is disabled, and the gains aren't used then either
+	m_controlExecutor.AddOutputStage([this]() {
+		if(!ElevatorPIDController.IsEnabled()) return;
+		ElevatorPID.UpdateGains(ElevatorPIDController.GetSetpoint(), ElevatorPIDController.GetInput());
+		ElevatorPIDController.SetPID(ElevatorPID.GetGain(consts::ELEVATOR_P),
+				ElevatorPID.GetGain(consts::ELEVATOR_I), ElevatorPID.GetGain(consts::ELEVATOR_D));
+	});
+	// Record the tick last so the log has the motor commands that were just sent
+	m_matchRecorder.Prepare();
+	m_controlExecutor.AddOutputStage([this]() { RecordMatchData(); });
+	m_controlExecutor.Start();
+	m_timingPublishTimer.Start();
+	m_telemetry.Start();
+	m_traceExporter.Start();
 
 	// Setup camera stream in a separate thread
 	std::thread visionThread(VisionThread);
 	visionThread.detach();
 
-	// Configure the SendableChoosers for auto
-	AutoLocationChooser->AddObject("Left Start", consts::AutoPosition::LEFT_START);
-	AutoLocationChooser->AddDefault("Middle Start", consts::AutoPosition::MIDDLE_START);
-	AutoLocationChooser->AddObject("Right Start", consts::AutoPosition::RIGHT_START);
+	// Configure the choosers for auto. The last argument is the label used in the "Auto Settings" summary
+	AutoLocationChooser.AddOption("Left Start", consts::AutoPosition::LEFT_START, "Left");
+	AutoLocationChooser.AddDefault("Middle Start", consts::AutoPosition::MIDDLE_START, "Middle");
+	AutoLocationChooser.AddOption("Right Start", consts::AutoPosition::RIGHT_START, "Right");
 
-	AutoObjectiveChooser->AddDefault("Default", consts::AutoObjective::DEFAULT);
-	AutoObjectiveChooser->AddObject("Switch", consts::AutoObjective::SWITCH);
-	AutoObjectiveChooser->AddObject("Scale", consts::AutoObjective::SCALE);
-	AutoObjectiveChooser->AddObject("Baseline", consts::AutoObjective::BASELINE);
+	AutoObjectiveChooser.AddDefault("Default", consts::AutoObjective::DEFAULT, "Default Path");
+	AutoObjectiveChooser.AddOption("Switch", consts::AutoObjective::SWITCH, "Switch");
+	AutoObjectiveChooser.AddOption("Scale", consts::AutoObjective::SCALE, "Scale");
+	AutoObjectiveChooser.AddOption("Baseline", consts::AutoObjective::BASELINE, "Baseline");
 
-	SwitchApproachChooser->AddDefault("Angle Shot", consts::SwitchApproach::FRONT);
-	SwitchApproachChooser->AddObject("Side Shot", consts::SwitchApproach::SIDE);
+	SwitchApproachChooser.AddDefault("Angle Shot", consts::SwitchApproach::FRONT, "Front");
+	SwitchApproachChooser.AddOption("Side Shot", consts::SwitchApproach::SIDE, "Side");
 
-	// Send the sendable choosers to SmartDashboard
-	SmartDashboard::PutData("Auto Position", AutoLocationChooser);
-	SmartDashboard::PutData("Auto Objective", AutoObjectiveChooser);
-	SmartDashboard::PutData("Switch Approach", SwitchApproachChooser);
+	// Send the choosers to SmartDashboard
+	AutoLocationChooser.Publish("Auto Position");
+	AutoObjectiveChooser.Publish("Auto Objective");
+	SwitchApproachChooser.Publish("Switch Approach");
 	SmartDashboard::PutNumber("Auto Delay", 0);
 }
 
+void Robot::RegisterTelemetry()
+{
+	m_telemetrySlots.angle = m_telemetry.AddNumber("Angle");
+	m_telemetrySlots.isNavXConnected = m_telemetry.AddBoolean("NavX Connected");
+	m_telemetrySlots.distance = m_telemetry.AddNumber("Distance");
+	m_telemetrySlots.driveVelocity = m_telemetry.AddNumber("Drive Velocity");
+	m_telemetrySlots.driveAcceleration = m_telemetry.AddNumber("Drive Acceleration");
+	m_telemetrySlots.elevatorHeight = m_telemetry.AddNumber("Elevator Height");
+	m_telemetrySlots.elevatorVelocity = m_telemetry.AddNumber("Elevator Velocity");
+	m_telemetrySlots.isDriveSpeedReduced = m_telemetry.AddBoolean("Drive Speed Reduction?");
+	m_telemetrySlots.isZeroingElevator = m_telemetry.AddBoolean("Zeroing Elevator Encoder?");
+	m_telemetrySlots.areOverridesPressed = m_telemetry.AddBoolean("OverridesPressed");
+	m_telemetrySlots.areOverridesReleased = m_telemetry.AddBoolean("OverridesReleased");
+	m_telemetrySlots.raiseElevatorOutput = m_telemetry.AddNumber("RaiseElev");
+	m_telemetrySlots.lowerElevatorOutput = m_telemetry.AddNumber("LowerElev");
+	m_telemetrySlots.autoSettings = m_telemetry.AddString("Auto Settings");
+}
+
+void Robot::RobotPeriodic()
+{
+	m_matchRecorder.Maintain();
+
+	// Publishing is much slower than recording, so the summaries only go out once in a while
+	if(m_timingPublishTimer.HasPeriodPassed(consts::TIMING_PUBLISH_PERIOD_S))
+	{
+		m_controlExecutor.PublishTiming();
+		m_disabledTiming.Publish();
+		m_autonomousTiming.Publish();
+		m_teleopTiming.Publish();
+		m_testTiming.Publish();
+		SmartDashboard::PutNumber("CAN Utilization", RobotController::GetCANStatus().percentBusUtilization * 100);
+		SmartDashboard::PutNumber("CAN Utilization Estimate", m_canBandwidth.GetEstimatedUtilization() * 100);
+	}
+}
+
+// Called from each Init, so the published timing only covers the current run of the mode.
+// Otherwise the control loop timing would mix every mode since the robot booted
+void Robot::ResetTiming(LoopTimer& modeTiming)
+{
+	modeTiming.Reset();
+	m_controlExecutor.ResetTiming();
+}
+
+void Robot::UpdateSnapshot()
+{
+	SensorSnapshot snapshot;
+	snapshot.timestamp = Timer::GetFPGATimestamp();
+
+	snapshot.elevatorHeight = ElevatorPID.GetHeightInches();
+	m_elevatorVelocity.Update(snapshot.elevatorHeight, ElevatorPID.GetVelocityInches(), snapshot.timestamp);
+	snapshot.elevatorVelocity = m_elevatorVelocity.GetVelocity();
+	snapshot.elevatorAcceleration = m_elevatorVelocity.GetAcceleration();
+
+	snapshot.leftDriveDistance = PulsesToInches(FrontLeftMotor.GetSelectedSensorPosition(0));
+	m_leftDriveVelocity.Update(snapshot.leftDriveDistance, DistancePID.GetVelocity(), snapshot.timestamp);
+	snapshot.leftDriveVelocity = m_leftDriveVelocity.GetVelocity();
+	snapshot.leftDriveAcceleration = m_leftDriveVelocity.GetAcceleration();
+
+	snapshot.rightDriveDistance = PulsesToInches(FrontRightMotor.GetSelectedSensorPosition(0));
+	snapshot.angle = AngleSensors.GetAngle();
+	snapshot.angularRate = AngleSensors.GetRate();
+
+	snapshot.leftDriveCurrent = FrontLeftMotor.GetOutputCurrent() + BackLeftMotor.GetOutputCurrent();
+	snapshot.rightDriveCurrent = FrontRightMotor.GetOutputCurrent() + BackRightMotor.GetOutputCurrent();
+	snapshot.elevatorCurrent = RightElevatorMotor.GetOutputCurrent() + LeftElevatorMotor.GetOutputCurrent();
+	snapshot.intakeCurrent = RightIntakeMotor.GetOutputCurrent() + LeftIntakeMotor.GetOutputCurrent();
+
+	snapshot.driveController = ReadController(DriveController);
+	snapshot.operatorController = ReadController(OperatorController);
+
+	std::lock_guard<std::mutex> lock(m_snapshotMutex);
+	m_snapshot = snapshot;
+}
+
+// Called by the ControlExecutor at the end of every tick. Nothing here waits on the main thread:
+// if it's writing the snapshot right now, the previous snapshot is recorded again. The Talon
+// currents and commands are the values cached from their last status frames and Set() calls
+void Robot::RecordMatchData()
+{
+	// A replay runs the robot logic on old snapshots, which shouldn't end up in the current log
+	if(m_isReplaying) return;
+
+	std::unique_lock<std::mutex> lock(m_snapshotMutex, std::try_to_lock);
+	if(lock.owns_lock())
+	{
+		m_recordedSnapshot = m_snapshot;
+		lock.unlock();
+	}
+
+	MatchRecord record;
+	FillMatchRecord(record, m_recordedSnapshot);
+	m_matchRecorder.Record(record);
+}
+
+// Also used by a replay to capture the outputs its robot logic produced
+void Robot::FillMatchRecord(MatchRecord& record, const SensorSnapshot& snapshot)
+{
+	record.timestamp = Timer::GetFPGATimestamp();
+	record.snapshotTimestamp = snapshot.timestamp;
+	record.elevatorHeight = snapshot.elevatorHeight;
+	record.elevatorVelocity = snapshot.elevatorVelocity;
+	record.leftDriveDistance = snapshot.leftDriveDistance;
+	record.leftDriveVelocity = snapshot.leftDriveVelocity;
+	record.rightDriveDistance = snapshot.rightDriveDistance;
+	record.angle = snapshot.angle;
+	record.angularRate = snapshot.angularRate;
+
+	RecordController(snapshot.driveController, record.driveAxes, record.driveButtons);
+	RecordController(snapshot.operatorController, record.operatorAxes, record.operatorButtons);
+
+	// In the order of RecordedTalon
+	WPI_TalonSRX* talons[NUM_RECORDED_TALONS] = {&FrontLeftMotor, &BackLeftMotor, &FrontRightMotor, &BackRightMotor,
+			&RightElevatorMotor, &LeftElevatorMotor, &RightIntakeMotor, &LeftIntakeMotor, &LinkageMotor};
+	for(int i = 0; i < NUM_RECORDED_TALONS; i++)
+	{
+		record.talonCurrents[i] = talons[i]->GetOutputCurrent();
+		record.talonCommands[i] = talons[i]->Get();
+	}
+
+	// In the order of RecordedLoop
+	ControlLoop* loops[NUM_RECORDED_LOOPS] = {&AngleController, &MaintainAngleController,
+			&DistanceController, &ElevatorPIDController};
+	record.enabledLoops = 0;
+	for(int i = 0; i < NUM_RECORDED_LOOPS; i++)
+	{
+		record.loopSetpoints[i] = loops[i]->GetSetpoint();
+		record.loopOutputs[i] = loops[i]->Get();
+		if(loops[i]->IsEnabled()) record.enabledLoops |= 1 << i;
+	}
+	record.robotMode = m_robotMode;
+	std::memset(record.reserved, 0, sizeof(record.reserved));
+}
+
+// Match logs are named after the match when the FMS is attached, e.g. "Q12_Auto"
+std::string Robot::GetMatchLogName(std::string mode)
+{
+	DriverStation& driverStation = DriverStation::GetInstance();
+	std::string matchType;
+	switch(driverStation.GetMatchType())
+	{
+	case DriverStation::kPractice:      matchType = "P"; break;
+	case DriverStation::kQualification: matchType = "Q"; break;
+	case DriverStation::kElimination:   matchType = "E"; break;
+	default:                            return mode;
+	}
+
+	return matchType + std::to_string(driverStation.GetMatchNumber()) + "_" + mode;
+}
+
+// Queues the timeline of the mode that just ended, e.g. "Q12_Auto_0.json", for the exporter
+// thread. The number keeps practice runs with the same name from overwriting each other
+void Robot::ExportTrace()
+{
+	if(m_traceName.empty() || !Tracer::GetInstance().IsEnabled()) return;
+
+	m_traceExporter.Export(m_traceName + "_" + std::to_string(m_numTraces++) + ".json");
+	m_traceName.clear();
+}
+
+ControllerSnapshot Robot::ReadController(XboxController& controller)
+{
+	ControllerSnapshot snapshot;
+	snapshot.leftX = controller.GetX(GenericHID::JoystickHand::kLeftHand);
+	snapshot.leftY = controller.GetY(GenericHID::JoystickHand::kLeftHand);
+	snapshot.rightX = controller.GetX(GenericHID::JoystickHand::kRightHand);
+	snapshot.rightY = controller.GetY(GenericHID::JoystickHand::kRightHand);
+	snapshot.leftTrigger = controller.GetTriggerAxis(GenericHID::JoystickHand::kLeftHand);
+	snapshot.rightTrigger = controller.GetTriggerAxis(GenericHID::JoystickHand::kRightHand);
+	snapshot.aButton = controller.GetAButton();
+	snapshot.bButton = controller.GetBButton();
+	snapshot.xButton = controller.GetXButton();
+	snapshot.yButton = controller.GetYButton();
+	snapshot.leftBumper = controller.GetBumper(GenericHID::JoystickHand::kLeftHand);
+	snapshot.rightBumper = controller.GetBumper(GenericHID::JoystickHand::kRightHand);
+	snapshot.backButton = controller.GetBackButton();
+	snapshot.startButton = controller.GetStartButton();
+
+	return snapshot;
+}
+
 START_ROBOT_CLASS(Robot)
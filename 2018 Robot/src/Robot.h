@@ -10,18 +10,38 @@
 #include <PID/AnglePIDOutput.h>
 #include <PID/ElevatorPIDHelper.h>
 #include <PID/DistancePIDHelper.h>
+#include <PID/MotionProfile.h>
+#include <PID/SettleDetector.h>
+#include <PID/RelayAutotuner.h>
 #include <Sensors/AngleSensorGroup.h>
 #include <Sensors/StabilizedUltrasonic.h>
+#include <Sensors/SensorSnapshot.h>
+#include <Sensors/VelocityEstimator.h>
+#include <Control/ControlLoop.h>
+#include <Control/ControlExecutor.h>
+#include <Control/DriveMixer.h>
+#include <Control/TalonMotionMagic.h>
+#include <Control/CanBandwidthManager.h>
+#include <Diagnostics/LoopTimer.h>
+#include <Diagnostics/Telemetry.h>
+#include <Diagnostics/DashboardControl.h>
+#include <Diagnostics/DashboardChooser.h>
+#include <Diagnostics/MatchRecorder.h>
+#include <Diagnostics/MatchReplay.h>
+#include <Diagnostics/TraceExporter.h>
+#include <Auto/AutoCommand.h>
+#include <Auto/CommandGroups.h>
+#include <Auto/AutoScheduler.h>
+#include <Auto/SettleCommand.h>
+#include <Auto/ProfileCommand.h>
+#include <Auto/GameDataListener.h>
+#include <mutex>
 
 using namespace frc;
 
 inline double PulsesToInches(double sensorPosition)
 {
-	double circumference = consts::WHEEL_DIAMETER * consts::PI;
-	double revolutions = sensorPosition / consts::PULSES_PER_REV;
-	double distance = revolutions * circumference;
-
-	return distance;
+	return (units::Ticks(sensorPosition) * consts::DRIVE_INCHES_PER_TICK).Value();
 }
 
 // Absolute value of a double precision floating point number
@@ -38,6 +58,7 @@ class Robot: public TimedRobot
 private:
 	// TODO: Update the following list after merging
 	// Here's a breakdown of what member objects we're declaring:
+	// - 1 Telemetry to publish the dashboard values from the loops in a background thread
 	// - 4 Motor Controllers for each of the drive motors (WPI_TalonSRX)
 	// - 2 SpeedControllerGroups to contain the left and right side motors
 	// - 1 Xbox Controller for controlling the robot
@@ -45,12 +66,23 @@ private:
 	// - 1 AngleSensorGroup for sensing the angle and motion of the robot
 	// 		- Internally contains one NavX (AHRS) and one ADXRS450_Gyro
 
-	// - 1 AnglePIDOutput to send turning motor output to DifferentialDrive during PID turning
-	// - 1 DistancePIDHelper to manage the source and motor output of DifferentialDrive during PID driving
+	// - 1 DriveMixer to combine the drive loop outputs into one DifferentialDrive command per control tick
+	// - 1 AnglePIDOutput to send turning motor output to the DriveMixer during PID turning
+	// - 1 DistancePIDHelper to manage the source and motor output of the DriveMixer during PID driving
 	// - 1 TalonPIDHelper to manage the source and motor output for the elevator motor
-	// - 4 PIDControllers to manage turning to angles, driving distances, maintaining an angle, and raising the elevator
+	// - 4 ControlLoops to manage turning to angles, driving distances, maintaining an angle, and raising the elevator
+	// - 1 TalonMotionMagic to optionally run the elevator loop on the Talon instead of the roboRIO
+	// - 1 CanBandwidthManager to set each Talon's status frame rates from what's read from it
+	// - 1 MatchRecorder to log every control tick to a file per match
+	// - 1 MatchReplay to run the teleop logic again on a match log while disabled
+	// - 1 TraceExporter to write each mode's trace from a low priority thread
+	// - 1 ControlExecutor to run all of the ControlLoops from one high priority thread
+
+	// - 3 DashboardChoosers for selecting an autonomous mode
+	// - 1 AutoScheduler to run the autonomous routine one step per robot loop
+	// - 1 precomputed auto plan for each field layout, built while disabled
 
-	// - 3 SendableChoosers for selecting an autonomous mode
+	Telemetry m_telemetry;   // Declared first so the loops can register their slots and publish until they stop
 
 	WPI_TalonSRX BackRightMotor;
 	WPI_TalonSRX FrontRightMotor;
@@ -64,6 +96,7 @@ private:
 	SpeedControllerGroup LeftMotors;
 	SpeedControllerGroup RightMotors;
 	DifferentialDrive DriveTrain;
+	DriveMixer m_driveMixer;
 	XboxController DriveController;
 	XboxController OperatorController;
 	AngleSensorGroup AngleSensors;
@@ -74,26 +107,136 @@ private:
 	ElevatorPIDHelper ElevatorPID;
 	AnglePIDOutput AnglePIDOut;
 	DistancePIDHelper DistancePID;
-	PIDController AngleController;
-	PIDController MaintainAngleController;
-	PIDController DistanceController;
-	PIDController ElevatorPIDController;
+	ControlLoop AngleController;
+	ControlLoop MaintainAngleController;
+	ControlLoop DistanceController;
+	ControlLoop ElevatorPIDController;
+	TalonMotionMagic m_elevatorMotionMagic;
+	CanBandwidthManager m_canBandwidth;
+	MatchRecorder m_matchRecorder;
+	SensorSnapshot m_recordedSnapshot;   // The last snapshot the recorder saw, only used by the control thread
+	std::atomic<int> m_robotMode;        // RecordedMode, set by each Init function
+	MatchReplay m_matchReplay;
+	std::atomic<bool> m_isReplaying;
+	std::string m_traceName;   // Name of the trace for the current mode, or empty when there's nothing to export
+	int m_numTraces;
+	TraceExporter m_traceExporter;
+	ControlExecutor m_controlExecutor;   // Stopped first in ~Robot, since its output stages use members declared after it
+
+	DashboardChooser<consts::AutoPosition> AutoLocationChooser;
+	DashboardChooser<consts::AutoObjective> AutoObjectiveChooser;
+	DashboardChooser<consts::SwitchApproach> SwitchApproachChooser;
+
+	AutoScheduler m_autoScheduler;
+
+	// Auto plans for the current dashboard selection, indexed by field layout
+	AutoCommandPtr m_autoPlans[consts::NUM_FIELD_LAYOUTS];
+	std::string m_autoPlanNames[consts::NUM_FIELD_LAYOUTS];
+	AutoCommandPtr m_baselinePlan;
+	bool m_areAutoPlansReady;
+	consts::AutoPosition m_plannedPosition;
+	consts::AutoObjective m_plannedObjective;
+	consts::SwitchApproach m_plannedApproach;
+	double m_plannedDelay;
+	bool m_isWaitingForGameData;
+	Timer m_gameDataTimer;
+	std::recursive_mutex m_autoPlanMutex;   // The plans are started from both the main and GameDataListener threads
+	// Held by the main thread while it updates the snapshot and runs auto, and by the GameDataListener
+	// while it runs the first step of the plan, so that step never overlaps the main loop
+	std::mutex m_autoStepMutex;
+	GameDataListener m_gameDataListener;   // Declared after the mutexes its thread locks
+
+	// The last gains proposed by the autotuner in Test mode and the loop they were tuned for
+	ControlLoop* m_autotunedLoop;
+	PIDGains m_autotunedGains;
+
+	// Sensor and controller values for the current robot loop. Only the main robot thread
+	// writes it, so other threads must hold m_snapshotMutex to read it. Auto commands that the
+	// GameDataListener runs are covered by m_autoStepMutex instead
+	SensorSnapshot m_snapshot;
+	std::mutex m_snapshotMutex;
 
-	SendableChooser<consts::AutoPosition> *AutoLocationChooser;
-	SendableChooser<consts::AutoObjective> *AutoObjectiveChooser;
-	SendableChooser<consts::SwitchApproach> *SwitchApproachChooser;
+	// Velocities and accelerations in the snapshot, estimated from the timestamped encoder readings
+	VelocityEstimator m_elevatorVelocity;
+	VelocityEstimator m_leftDriveVelocity;
 
 	// Member variables to keep track of the state of the Elevator PID
 	bool m_isElevatorLowering;
 	bool m_isElevatorInAutoMode;
 	int m_targetElevatorStep;
+	ControllerSnapshot m_prevOperatorController;   // The operator controller in the last Elevator() call, for bumper presses
 	Timer EjectTimer;
 
+	// Timing of each periodic function, published with the control loop timing at a low rate
+	LoopTimer m_disabledTiming;
+	LoopTimer m_autonomousTiming;
+	LoopTimer m_teleopTiming;
+	LoopTimer m_testTiming;
+	Timer m_timingPublishTimer;
+
+	// Telemetry slots for the values published every robot loop, registered in the constructor
+	struct TelemetrySlots
+	{
+		Telemetry::Slot angle;
+		Telemetry::Slot isNavXConnected;
+		Telemetry::Slot distance;
+		Telemetry::Slot driveVelocity;
+		Telemetry::Slot driveAcceleration;
+		Telemetry::Slot elevatorHeight;
+		Telemetry::Slot elevatorVelocity;
+		Telemetry::Slot isDriveSpeedReduced;
+		Telemetry::Slot isZeroingElevator;
+		Telemetry::Slot areOverridesPressed;
+		Telemetry::Slot areOverridesReleased;
+		Telemetry::Slot raiseElevatorOutput;
+		Telemetry::Slot lowerElevatorOutput;
+		Telemetry::Slot autoSettings;
+	};
+	TelemetrySlots m_telemetrySlots;
+
+	// Test toggles and tuning values set from the dashboard. DisabledInit and TestInit reset them,
+	// which only sends the ones that were changed
+	struct DashboardControls
+	{
+		DashboardBoolean replayMatchLog{"Replay Match Log", false};
+		DashboardBoolean testAngle{"Test Angle", false};
+		DashboardBoolean testMaintain{"Test Maintain", false};
+		DashboardBoolean testDistance{"Test Distance", false};
+		DashboardBoolean resetAngle{"Reset Angle", false};
+		DashboardBoolean resetEncoders{"Reset Encoders", false};
+		DashboardNumber testMaintainOutput{"Test Maintain Output", 0};
+		DashboardBoolean enableTestDistanceOutput{"Enable Test Distance Output", false};
+		DashboardBoolean enableMaintainController{"Enable Maintain Controller", false};
+		DashboardBoolean toggleMaintainTest{"Toggle Maintain Test", false};
+		DashboardBoolean goForwardTurnRight{"Go Forward, Turn Right", false};
+		DashboardBoolean toggleDistanceTest{"Toggle Distance Test", false};
+		DashboardBoolean testAutoElevator{"Test Auto Elevator", false};
+		DashboardNumber desiredIncrement{"Desired Increment", 0};
+		DashboardBoolean goToIncrement{"Go to Increment", false};
+		DashboardBoolean driveTest{"Drive", false};
+		DashboardBoolean fullElevatorTest{"Full Elevator", false};
+		DashboardBoolean manualElevatorTest{"Manual Elevator", false};
+		DashboardBoolean pidElevatorTest{"PID Elevator", false};
+		DashboardBoolean intakeTest{"Intake", false};
+		DashboardBoolean toggleElevatorSafety{"Toggle Elevator Safety", false};
+		DashboardNumber elevatorSetpoint{"Elevator Setpoint", 0};
+		DashboardBoolean resetElevatorEncoder{"Reset Elevator Encoder?", false};
+		DashboardNumber elevatorP{"Elevator P", 0.03};
+		DashboardNumber elevatorConstant{"Elevator Constant", 0.5};
+		DashboardNumber elevatorLimit{"Elevator Limit", 0.8};
+		DashboardBoolean autotuneAngle{"Autotune Angle", false};
+		DashboardBoolean autotuneDistance{"Autotune Distance", false};
+		DashboardBoolean autotuneElevator{"Autotune Elevator", false};
+		DashboardBoolean applyAutotunedGains{"Apply Autotuned Gains", false};
+	};
+	DashboardControls m_dashboardControls;
+
 public:
 	// Constructor and virtual functions
 	Robot();
 	~Robot();
 	void RobotInit() override;
+	void RobotPeriodic() override;
 	void DisabledInit() override;
 	void DisabledPeriodic() override;
 	void AutonomousInit() override;
@@ -103,18 +246,45 @@ public:
 	void TestInit() override;
 	void TestPeriodic() override;
 
+	void RegisterTelemetry();
+	void ResetTiming(LoopTimer& modeTiming);
+
+	// Reads every sensor and controller once at the start of each periodic function
+	void UpdateSnapshot();
+	ControllerSnapshot ReadController(XboxController& controller);
+
+	// Match logging and replay
+	void RecordMatchData();
+	void FillMatchRecord(MatchRecord& record, const SensorSnapshot& snapshot);
+	std::string GetMatchLogName(std::string mode);
+	void ExportTrace();
+	void ReplayPeriodic();
+	void StartReplay(std::string path);
+	void FinishReplay();
+
+	// Autonomous plan selection
+	void UpdateAutoPlans();
+	bool StartAutoPlanIfReady(std::string gameData, bool isMainThread);
+	void OnGameData(std::string gameData);
+	AutoCommandPtr BuildAutoRoutine(consts::AutoPosition position, consts::AutoObjective objective,
+			consts::SwitchApproach approach, double delay, std::string gameData, std::string& pathName);
+
 	// Autonomous Robot Functionality
-	void DriveFor(double seconds, double speed = 0.5);
-	void DriveDistance(double distance, double timeout = consts::PID_TIMEOUT_S);
-	void TurnAngle(double angle, double timeout = consts::PID_TIMEOUT_S);
-	void DriveToBaseline();
-	void SidePath(consts::AutoPosition start, char switchPosition, char scalePosition);
-	void OppositeSwitch(consts::AutoPosition start);
-	void OppositeScale(consts::AutoPosition start);
-	void MiddlePath(char switchPosition);
-	void DropCube(consts::ElevatorIncrement elevatorSetpoint);
-	void EjectCube(double intakeSpeed = consts::INTAKE_SPEED);
-	void RaiseElevator(consts::ElevatorIncrement elevatorSetpoint, double timeout = consts::PID_TIMEOUT_S);
+	// - Each of these builds a command for the AutoScheduler instead of running
+	//   the step itself, so none of them block the main robot thread
+	AutoCommandPtr AutoStatus(std::string status);
+	AutoCommandPtr DriveFor(double seconds, double speed = 0.5);
+	AutoCommandPtr DriveDistance(double distance, double timeout = consts::PID_TIMEOUT_S);
+	AutoCommandPtr TurnAngle(double angle, double timeout = consts::PID_TIMEOUT_S);
+	AutoCommandPtr DriveToBaseline();
+	AutoCommandPtr SidePath(consts::AutoPosition start, consts::SwitchApproach approach, char switchPosition, char scalePosition);
+	AutoCommandPtr OppositeSwitch(consts::AutoPosition start, consts::SwitchApproach approach);
+	AutoCommandPtr OppositeScale(consts::AutoPosition start);
+	AutoCommandPtr MiddlePath(char switchPosition);
+	AutoCommandPtr DropCube(consts::ElevatorIncrement elevatorSetpoint);
+	AutoCommandPtr EjectCube(double intakeSpeed = consts::INTAKE_SPEED);
+	AutoCommandPtr RaiseElevator(consts::ElevatorIncrement elevatorSetpoint, double timeout = consts::PID_TIMEOUT_S);
+	AutoCommandPtr HoldCube();
 
 	// Camera Stream code
 	static void VisionThread();
@@ -127,6 +297,7 @@ public:
 	void ZeroMotors();
 
 	// Teleoperated helper functions
+	void TeleopLogic();
 	void Drive();
 	void Elevator();
 	void ManualElevator();
@@ -158,6 +329,9 @@ public:
 	void MaintainHeadingTest();
 	void DriveDistanceTest(double distance);
 	void TurnAngleTest(double angle);
+	void AutotuneTest();
+	AutoCommandPtr Autotune(std::string name, ControlLoop& loop, PIDOutput& output,
+			double amplitude, double hysteresis, double settleTime, std::function<double()> getBias = nullptr);
 };
 
 #endif /* ROBOT */
@@ -1,15 +1,69 @@
 #include "AngleSensorGroup.h"
+#include "../Constants.h"
 
 AngleSensorGroup::AngleSensorGroup(SPI::Port navXPort, SPI::Port gyroPort) :
-	m_NavX(navXPort),
-	m_Gyro(gyroPort)
+	m_NavX(navXPort, consts::NAVX_UPDATE_RATE_HZ),
+	m_Gyro(gyroPort),
+	m_sampler([this]() { Sample(); }),
+	m_angle(0),
+	m_rate(0),
+	m_gyroBias(0),
+	m_navXOffset(0),
+	m_prevGyroAngle(0),
+	m_prevTime(0),
+	m_isNavXAligned(false),
+	m_isNavXConnected(false),
+	m_hasSampled(false),
+	m_mutex()
 {
-
+	m_sampler.StartPeriodic(1. / consts::NAVX_UPDATE_RATE_HZ);
 }
 
 AngleSensorGroup::~AngleSensorGroup()
 {
+	m_sampler.Stop();
+}
+
+void AngleSensorGroup::Sample()
+{
+	// Read the sensors outside of the lock so the control loops never wait on SPI
+	units::Seconds time(Timer::GetFPGATimestamp());
+	units::Degrees gyroAngle(m_Gyro.GetAngle());
+	units::DegreesPerSecond gyroRate(m_Gyro.GetRate());
+	bool isNavXConnected = m_NavX.IsConnected();
+	units::Degrees navXAngle(isNavXConnected ? m_NavX.GetAngle() : 0);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if(!m_hasSampled)
+	{
+		m_prevGyroAngle = gyroAngle;
+		m_prevTime = time;
+		m_hasSampled = true;
+	}
+	units::Seconds dt = time - m_prevTime;
+
+	m_angle += gyroAngle - m_prevGyroAngle - m_gyroBias * dt;
+	m_rate = gyroRate - m_gyroBias;
+	m_prevGyroAngle = gyroAngle;
+	m_prevTime = time;
 
+	if(!isNavXConnected)
+	{
+		m_isNavXAligned = false;
+	}
+	else if(!m_isNavXAligned)
+	{
+		m_navXOffset = m_angle - navXAngle;
+		m_isNavXAligned = true;
+	}
+	else
+	{
+		// If the ADXRS450 reads high compared to the NavX, the correction is negative and the bias goes up
+		units::Degrees correction = navXAngle + m_navXOffset - m_angle;
+		m_angle += consts::ANGLE_FUSION_GAIN * correction;
+		m_gyroBias -= consts::GYRO_BIAS_GAIN * correction;
+	}
+	m_isNavXConnected = isNavXConnected;
 }
 
 double AngleSensorGroup::PIDGet()
@@ -19,18 +73,33 @@ double AngleSensorGroup::PIDGet()
 
 void AngleSensorGroup::Reset()
 {
-	m_NavX.ZeroYaw();
-	m_Gyro.Reset();
+	// The NavX lines back up with the new zero on the next sample
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_angle = units::Degrees(0);
+	m_isNavXAligned = false;
 }
 
 double AngleSensorGroup::GetAngle()
 {
-	if(m_NavX.IsConnected())
-	{
-		return m_NavX.GetYaw();
-	}
-	else
-	{
-		return m_Gyro.GetAngle();
-	}
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_angle.Value();
+}
+
+// Returns the turning rate in degrees per second
+double AngleSensorGroup::GetRate()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_rate.Value();
+}
+
+double AngleSensorGroup::GetGyroBias()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_gyroBias.Value();
+}
+
+bool AngleSensorGroup::IsNavXConnected()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_isNavXConnected;
 }
@@ -3,14 +3,38 @@
 
 #include <WPILib.h>
 #include <AHRS.h>
+#include <mutex>
+#include "../Units.h"
 
 using namespace frc;
 
+// Fuses the NavX and the ADXRS450 into one heading with a complementary filter.
+// - A Notifier samples both sensors at the NavX update rate. The ADXRS450's angle change since the
+//   last sample moves the estimate, and the NavX angle slowly pulls it back so that gyro drift
+//   can't build up. The pull is also used to estimate the ADXRS450's bias
+// - The NavX reading is offset to line up with the estimate whenever it (re)connects, so the
+//   heading stays continuous if the NavX drops out or comes back mid-match
+// - IsConnected() is only called from the sampler, never from the control loops
+// - Reset() zeros the estimate in software, so there's no wait for either sensor to re-zero
 class AngleSensorGroup : public PIDSource
 {
 private:
 	AHRS m_NavX;
 	ADXRS450_Gyro m_Gyro;
+	Notifier m_sampler;
+
+	units::Degrees m_angle;            // Fused heading. Unlike the NavX yaw it doesn't wrap
+	units::DegreesPerSecond m_rate;    // ADXRS450 rate with the estimated bias removed
+	units::DegreesPerSecond m_gyroBias;
+	units::Degrees m_navXOffset;       // Added to the NavX angle to line it up with the estimate
+	units::Degrees m_prevGyroAngle;
+	units::Seconds m_prevTime;
+	bool m_isNavXAligned;
+	bool m_isNavXConnected;
+	bool m_hasSampled;
+	mutable std::mutex m_mutex;
+
+	void Sample();
 
 public:
 	AngleSensorGroup(SPI::Port navXPort, SPI::Port gyroPort);
@@ -20,6 +44,9 @@ public:
 
 	void Reset();
 	double GetAngle();
+	double GetRate();
+	double GetGyroBias();
+	bool IsNavXConnected();
 };
 
 #endif
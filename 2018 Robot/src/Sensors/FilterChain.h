@@ -0,0 +1,263 @@
+#ifndef FILTER_CHAIN
+#define FILTER_CHAIN
+
+#include <WPILib.h>
+#include <chrono>
+#include <cmath>
+#include <tuple>
+#include <type_traits>
+#include "SlidingWindowFilter.h"
+
+using namespace frc;
+
+// Sensor filter stages. Each stage has Calculate(value, dt), which returns the filtered value,
+// and Reset(). None of them allocate or use virtual functions, so a FilterChain of them is
+// resolved at compile time and can be inlined into the source it wraps.
+// The first sample after a Reset() passes through every stage unchanged
+
+// Median of the last N samples
+template<int N>
+class MedianStage
+{
+private:
+	SlidingWindowFilter<N> m_window;
+
+public:
+	double Calculate(double value, double dt)
+	{
+		m_window.Push(value);
+		return m_window.GetMedian();
+	}
+
+	double GetMean()
+	{
+		return m_window.GetMean();
+	}
+
+	void Reset()
+	{
+		m_window.Reset();
+	}
+};
+
+// Exponential moving average with a time constant in seconds, so it behaves the same
+// no matter how often it's called
+class EmaStage
+{
+private:
+	double m_timeConstant;
+	double m_value;
+	bool m_hasValue;
+
+public:
+	EmaStage(double timeConstant) : m_timeConstant(timeConstant), m_value(0), m_hasValue(false) {}
+
+	double Calculate(double value, double dt)
+	{
+		if(!m_hasValue || m_timeConstant + dt <= 0)
+		{
+			m_value = value;
+			m_hasValue = true;
+			return m_value;
+		}
+		m_value += (value - m_value) * dt / (m_timeConstant + dt);
+		return m_value;
+	}
+
+	void Reset()
+	{
+		m_hasValue = false;
+	}
+};
+
+// Limits how fast the value can change, in units per second
+class RateLimitStage
+{
+private:
+	double m_maxRate;
+	double m_value;
+	bool m_hasValue;
+
+public:
+	RateLimitStage(double maxRate) : m_maxRate(maxRate), m_value(0), m_hasValue(false) {}
+
+	double Calculate(double value, double dt)
+	{
+		if(!m_hasValue)
+		{
+			m_value = value;
+			m_hasValue = true;
+			return m_value;
+		}
+		double maxChange = m_maxRate * dt;
+		m_value += std::fmax(-maxChange, std::fmin(maxChange, value - m_value));
+		return m_value;
+	}
+
+	void Reset()
+	{
+		m_hasValue = false;
+	}
+};
+
+// Holds the last good value when a sample jumps further than maxJump from it. If more than
+// maxRejections samples in a row are rejected, the jump is taken to be real and accepted
+class OutlierRejectStage
+{
+private:
+	double m_maxJump;
+	int m_maxRejections;
+	int m_rejections;
+	double m_value;
+	bool m_hasValue;
+
+public:
+	OutlierRejectStage(double maxJump, int maxRejections) :
+		m_maxJump(maxJump), m_maxRejections(maxRejections), m_rejections(0), m_value(0), m_hasValue(false) {}
+
+	double Calculate(double value, double dt)
+	{
+		if(m_hasValue && std::fabs(value - m_value) > m_maxJump && m_rejections < m_maxRejections)
+		{
+			m_rejections++;
+			return m_value;
+		}
+		m_rejections = 0;
+		m_value = value;
+		m_hasValue = true;
+		return m_value;
+	}
+
+	void Reset()
+	{
+		m_rejections = 0;
+		m_hasValue = false;
+	}
+};
+
+// 1-D Kalman filter for a value that drifts like a random walk. processNoise is the variance
+// the value gains per second and measurementNoise is the variance of one sample
+class KalmanStage
+{
+private:
+	double m_processNoise;
+	double m_measurementNoise;
+	double m_estimate;
+	double m_variance;
+	bool m_hasValue;
+
+public:
+	KalmanStage(double processNoise, double measurementNoise) :
+		m_processNoise(processNoise), m_measurementNoise(measurementNoise), m_estimate(0), m_variance(0), m_hasValue(false) {}
+
+	double Calculate(double value, double dt)
+	{
+		if(!m_hasValue)
+		{
+			m_estimate = value;
+			m_variance = m_measurementNoise;
+			m_hasValue = true;
+			return m_estimate;
+		}
+		m_variance += m_processNoise * dt;
+		double gain = m_variance / (m_variance + m_measurementNoise);
+		m_estimate += gain * (value - m_estimate);
+		m_variance *= 1 - gain;
+		return m_estimate;
+	}
+
+	void Reset()
+	{
+		m_hasValue = false;
+	}
+};
+
+// Runs a value through each stage in order, e.g.
+//   FilterChain<OutlierRejectStage, MedianStage<5>> chain(OutlierRejectStage(12, 3), MedianStage<5>());
+template<typename... Stages>
+class FilterChain
+{
+private:
+	std::tuple<Stages...> m_stages;
+
+	template<std::size_t I>
+	typename std::enable_if<I == sizeof...(Stages), double>::type CalculateFrom(double value, double dt)
+	{
+		return value;
+	}
+
+	template<std::size_t I>
+	typename std::enable_if<I < sizeof...(Stages), double>::type CalculateFrom(double value, double dt)
+	{
+		return CalculateFrom<I + 1>(std::get<I>(m_stages).Calculate(value, dt), dt);
+	}
+
+	template<std::size_t I>
+	typename std::enable_if<I == sizeof...(Stages)>::type ResetFrom()
+	{
+
+	}
+
+	template<std::size_t I>
+	typename std::enable_if<I < sizeof...(Stages)>::type ResetFrom()
+	{
+		std::get<I>(m_stages).Reset();
+		ResetFrom<I + 1>();
+	}
+
+public:
+	FilterChain(Stages... stages) : m_stages(stages...) {}
+
+	double Calculate(double value, double dt)
+	{
+		return CalculateFrom<0>(value, dt);
+	}
+
+	void Reset()
+	{
+		ResetFrom<0>();
+	}
+
+	template<std::size_t I>
+	typename std::tuple_element<I, std::tuple<Stages...>>::type& GetStage()
+	{
+		return std::get<I>(m_stages);
+	}
+};
+
+// Wraps any PIDSource with a FilterChain. The time between PIDGet() calls is measured,
+// so the time based stages work whether it's read by the ControlExecutor or a periodic function
+template<typename Chain>
+class FilteredSource : public PIDSource
+{
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	PIDSource& m_source;
+	Chain m_chain;
+	Clock::time_point m_prevTime;
+	bool m_hasPrevTime;
+
+public:
+	FilteredSource(PIDSource& source, Chain chain) :
+		m_source(source), m_chain(chain), m_prevTime(), m_hasPrevTime(false) {}
+	virtual ~FilteredSource() {}
+
+	double PIDGet() override
+	{
+		Clock::time_point time = Clock::now();
+		double dt = m_hasPrevTime ? std::chrono::duration<double>(time - m_prevTime).count() : 0;
+		m_prevTime = time;
+		m_hasPrevTime = true;
+
+		return m_chain.Calculate(m_source.PIDGet(), dt);
+	}
+
+	void Reset()
+	{
+		m_chain.Reset();
+		m_hasPrevTime = false;
+	}
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef SENSOR_SNAPSHOT
+#define SENSOR_SNAPSHOT
+
+// Everything the robot logic reads from the sensors and controllers, captured once at the start
+// of each periodic function so that every function in that loop sees the same values from the
+// same point in time without reading the CAN bus again
+
+struct ControllerSnapshot
+{
+	double leftX;
+	double leftY;
+	double rightX;
+	double rightY;
+	double leftTrigger;
+	double rightTrigger;
+	bool aButton;
+	bool bButton;
+	bool xButton;
+	bool yButton;
+	bool leftBumper;
+	bool rightBumper;
+	bool backButton;
+	bool startButton;
+};
+
+struct SensorSnapshot
+{
+	double timestamp;            // FPGA time in seconds
+
+	double elevatorHeight;       // Inches
+	double elevatorVelocity;     // Inches per second
+	double elevatorAcceleration; // Inches per second squared
+	double leftDriveDistance;    // Inches
+	double leftDriveVelocity;    // Inches per second
+	double leftDriveAcceleration;// Inches per second squared
+	double rightDriveDistance;   // Inches
+	double angle;                // Degrees
+	double angularRate;          // Degrees per second
+
+	// Summed output current of each pair of motors in amps
+	double leftDriveCurrent;
+	double rightDriveCurrent;
+	double elevatorCurrent;
+	double intakeCurrent;
+
+	ControllerSnapshot driveController;
+	ControllerSnapshot operatorController;
+};
+
+#endif
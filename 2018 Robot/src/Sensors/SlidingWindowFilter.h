@@ -0,0 +1,156 @@
+#ifndef SLIDING_WINDOW_FILTER
+#define SLIDING_WINDOW_FILTER
+
+// Median and mean of the last N samples without any heap allocation.
+// - The samples live in a ring buffer, and a max heap of the lower half and a min heap of the
+//   upper half share one array of indices around the median (Hardle and Steiger's "mediator").
+//   Replacing the oldest sample only sifts it through one heap, so Push() is O(log N) and
+//   GetMedian() is O(1)
+// - With an even number of samples, the median is the upper of the two middle samples
+// - The mean is a running sum that is recomputed exactly every time the ring buffer wraps,
+//   so rounding errors can't build up
+template<int N>
+class SlidingWindowFilter
+{
+	static_assert(N > 0, "SlidingWindowFilter needs room for at least one sample");
+
+private:
+	double m_samples[N];
+	int m_heapPositions[N];    // Where each sample is in the heap: 0 is the median, < 0 is the
+	int m_heapStorage[N];      // max heap and > 0 is the min heap
+	int* m_heap;               // Points into m_heapStorage so that it can be indexed from -N/2 up to (N-1)/2
+	int m_next;
+	int m_count;
+	double m_sum;
+
+	int MaxHeapCount() const { return m_count / 2; }
+	int MinHeapCount() const { return (m_count - 1) / 2; }
+
+	bool IsLess(int i, int j) const
+	{
+		return m_samples[m_heap[i]] < m_samples[m_heap[j]];
+	}
+
+	// Swaps two heap nodes if the first is less than the second
+	bool SwapIfLess(int i, int j)
+	{
+		if(!IsLess(i, j)) return false;
+
+		int temp = m_heap[i];
+		m_heap[i] = m_heap[j];
+		m_heap[j] = temp;
+		m_heapPositions[m_heap[i]] = i;
+		m_heapPositions[m_heap[j]] = j;
+		return true;
+	}
+
+	// Both sift down starting by comparing node i with its parent. The heap roots (1 and -1)
+	// have the median as their only parent
+	void MinSortDown(int i)
+	{
+		for(; i <= MinHeapCount(); i *= 2)
+		{
+			if(i > 1 && i < MinHeapCount() && IsLess(i + 1, i)) i++;
+			if(!SwapIfLess(i, i / 2)) break;
+		}
+	}
+
+	void MaxSortDown(int i)
+	{
+		for(; i >= -MaxHeapCount(); i *= 2)
+		{
+			if(i < -1 && i > -MaxHeapCount() && IsLess(i, i - 1)) i--;
+			if(!SwapIfLess(i / 2, i)) break;
+		}
+	}
+
+	// Both return true if the sample made it all the way up to the median
+	bool MinSortUp(int i)
+	{
+		while(i > 0 && SwapIfLess(i, i / 2)) i /= 2;
+		return i == 0;
+	}
+
+	bool MaxSortUp(int i)
+	{
+		while(i < 0 && SwapIfLess(i / 2, i)) i /= 2;
+		return i == 0;
+	}
+
+public:
+	SlidingWindowFilter() :
+		m_heap(m_heapStorage + N / 2)
+	{
+		Reset();
+	}
+
+	void Reset()
+	{
+		// Samples are handed out to the median, max heap and min heap in turn: 0, -1, 1, -2, 2...
+		for(int i = 0; i < N; i++)
+		{
+			m_samples[i] = 0;
+			m_heapPositions[i] = ((i + 1) / 2) * ((i & 1) ? -1 : 1);
+			m_heap[m_heapPositions[i]] = i;
+		}
+		m_next = 0;
+		m_count = 0;
+		m_sum = 0;
+	}
+
+	// Adds a sample and drops the oldest one once the window is full
+	void Push(double sample)
+	{
+		bool isNew = m_count < N;
+		int position = m_heapPositions[m_next];
+		double oldSample = m_samples[m_next];
+
+		m_samples[m_next] = sample;
+		m_sum += sample - (isNew ? 0 : oldSample);
+		m_next = (m_next + 1) % N;
+		if(isNew) m_count++;
+
+		if(position > 0)
+		{
+			if(!isNew && oldSample < sample) MinSortDown(position * 2);
+			else if(MinSortUp(position)) MaxSortDown(-1);
+		}
+		else if(position < 0)
+		{
+			if(!isNew && sample < oldSample) MaxSortDown(position * 2);
+			else if(MaxSortUp(position)) MinSortDown(1);
+		}
+		else
+		{
+			if(MaxHeapCount() > 0) MaxSortDown(-1);
+			if(MinHeapCount() > 0) MinSortDown(1);
+		}
+
+		if(m_next == 0)
+		{
+			m_sum = 0;
+			for(int i = 0; i < m_count; i++)
+			{
+				m_sum += m_samples[i];
+			}
+		}
+	}
+
+	int GetCount() const
+	{
+		return m_count;
+	}
+
+	// Both return 0 until the first sample has been pushed
+	double GetMedian() const
+	{
+		return m_count == 0 ? 0 : m_samples[m_heap[0]];
+	}
+
+	double GetMean() const
+	{
+		return m_count == 0 ? 0 : m_sum / m_count;
+	}
+};
+
+#endif
@@ -1,28 +1,8 @@
 #include "StabilizedUltrasonic.h"
 
-double average(std::deque<double>& array)
-{
-	double avg = 0;
-	for(unsigned int i = 0; i < array.size(); i++)
-	{
-		avg += array[i];
-	}
-	avg /= array.size();
-
-	return avg;
-}
-
-double median(std::deque<double> array)
-{
-	// Can't use a reference because 'nth_element' would reorder the
-	// original array
-	size_t midPoint = array.size() / 2;
-	nth_element(array.begin(), array.begin() + midPoint, array.end());
-	return array[midPoint];
-}
-
 StabilizedUltrasonic::StabilizedUltrasonic(int pingChannel, int echoChannel) :
-	DistanceSensor(pingChannel, echoChannel)
+	DistanceSensor(pingChannel, echoChannel),
+	m_prevDistances(OutlierRejectStage(MAX_DISTANCE_JUMP, MAX_REJECTED_DISTANCES), MedianStage<MAX_NUM_OF_DISTANCES>())
 {
 
 }
@@ -40,14 +20,13 @@ double StabilizedUltrasonic::PIDGet()
 // Return the median of the past few distance values
 double StabilizedUltrasonic::GetRangeInches()
 {
-	// Delete the oldest measurement when the array of old distances
-	// reaches max capacity
-	if(m_prevDistances.size() == MAX_NUM_OF_DISTANCES)
-	{
-		m_prevDistances.pop_front();
-	}
-	m_prevDistances.push_back(DistanceSensor.GetRangeInches());
+	// Drop pings that jump too far from the last distance (e.g. echoes off something else),
+	// then use the median of the past few measurements as the current distance
+	return m_prevDistances.Calculate(DistanceSensor.GetRangeInches(), 0);
+}
 
-	// Use the median of the past few measurements as the current distance
-	return median(m_prevDistances);
+// Return the mean of the past few distance values without taking a new measurement
+double StabilizedUltrasonic::GetAverageRangeInches()
+{
+	return m_prevDistances.GetStage<1>().GetMean();
 }
@@ -3,8 +3,7 @@
 
 #include <WPILib.h>
 #include <ctre/Phoenix.h>
-#include <cmath>
-#include <deque>
+#include "FilterChain.h"
 
 using namespace frc;
 
@@ -13,13 +12,16 @@ class StabilizedUltrasonic : public PIDSource
 private:
 	Ultrasonic DistanceSensor;
 	static constexpr int MAX_NUM_OF_DISTANCES = 11;
-	std::deque<double> m_prevDistances;
+	static constexpr double MAX_DISTANCE_JUMP = 24;   // Inches
+	static constexpr int MAX_REJECTED_DISTANCES = 3;
+	FilterChain<OutlierRejectStage, MedianStage<MAX_NUM_OF_DISTANCES>> m_prevDistances;
 
 public:
 	StabilizedUltrasonic(int pingChannel, int echoChannel);
 	virtual ~StabilizedUltrasonic();
 	double PIDGet() override;
 	double GetRangeInches();
+	double GetAverageRangeInches();
 };
 
 #endif
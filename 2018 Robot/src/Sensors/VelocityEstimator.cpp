@@ -0,0 +1,97 @@
+#include "VelocityEstimator.h"
+#include <cmath>
+
+VelocityEstimator::VelocityEstimator(double alpha, double measuredVelocityWeight, double maxVelocity, double maxSamplePeriod) :
+	m_alpha(alpha),
+	m_beta(alpha * alpha / (2 - alpha)),
+	m_gamma(0),
+	m_measuredVelocityWeight(measuredVelocityWeight),
+	m_maxVelocity(maxVelocity),
+	m_maxSamplePeriod(maxSamplePeriod),
+	m_position(0),
+	m_velocity(0),
+	m_acceleration(0),
+	m_prevTimestamp(0),
+	m_hasSample(false)
+{
+	m_gamma = m_beta * m_beta / (2 * m_alpha);
+}
+
+VelocityEstimator::~VelocityEstimator()
+{
+
+}
+
+void VelocityEstimator::Update(double position, double timestamp)
+{
+	Track(position, 0, timestamp);
+}
+
+void VelocityEstimator::Update(double position, double measuredVelocity, double timestamp)
+{
+	if(Track(position, measuredVelocity, timestamp))
+	{
+		m_velocity += m_measuredVelocityWeight * (measuredVelocity - m_velocity);
+	}
+}
+
+void VelocityEstimator::Reset()
+{
+	m_hasSample = false;
+	m_position = 0;
+	m_velocity = 0;
+	m_acceleration = 0;
+}
+
+double VelocityEstimator::GetPosition()
+{
+	return m_position;
+}
+
+double VelocityEstimator::GetVelocity()
+{
+	return m_velocity;
+}
+
+double VelocityEstimator::GetAcceleration()
+{
+	return m_acceleration;
+}
+
+void VelocityEstimator::Restart(double position, double velocity, double timestamp)
+{
+	m_position = position;
+	m_velocity = velocity;
+	m_acceleration = 0;
+	m_prevTimestamp = timestamp;
+	m_hasSample = true;
+}
+
+// Returns false if the sample was ignored or the tracker had to restart from it
+bool VelocityEstimator::Track(double position, double restartVelocity, double timestamp)
+{
+	double dt = timestamp - m_prevTimestamp;
+	if(!m_hasSample || dt > m_maxSamplePeriod)
+	{
+		Restart(position, restartVelocity, timestamp);
+		return false;
+	}
+	if(dt <= 0) return false;
+
+	// Predict where the mechanism should be by now, then correct by part of the difference
+	double predictedPosition = m_position + m_velocity * dt + 0.5 * m_acceleration * dt * dt;
+	double predictedVelocity = m_velocity + m_acceleration * dt;
+	double residual = position - predictedPosition;
+
+	if(std::fabs(residual) / dt > m_maxVelocity)
+	{
+		Restart(position, restartVelocity, timestamp);
+		return false;
+	}
+
+	m_position = predictedPosition + m_alpha * residual;
+	m_velocity = predictedVelocity + m_beta * residual / dt;
+	m_acceleration += 2 * m_gamma * residual / (dt * dt);
+	m_prevTimestamp = timestamp;
+	return true;
+}
@@ -0,0 +1,47 @@
+#ifndef VELOCITY_ESTIMATOR
+#define VELOCITY_ESTIMATOR
+
+// Estimates the velocity and acceleration of a mechanism from timestamped position samples with
+// an alpha-beta-gamma tracker. It predicts where the mechanism should be from the last estimate
+// and corrects by a fraction of the difference, so the velocity doesn't lag behind like a
+// differentiated and low-pass filtered position would. The loops still run on the raw position.
+// - beta and gamma are derived from alpha so that the tracker is critically damped. A higher
+//   alpha follows changes faster but passes more of the encoder noise through
+// - A measured velocity (e.g. the Talon's, which is averaged over the last 100ms) can be blended
+//   in to pull the estimate back when the position is too coarse to see slow movement
+// - The tracker restarts from the current sample when the samples are too far apart in time or
+//   the position jumps faster than the mechanism can move, e.g. when the encoder is zeroed
+class VelocityEstimator
+{
+private:
+	double m_alpha;
+	double m_beta;
+	double m_gamma;
+	double m_measuredVelocityWeight;
+	double m_maxVelocity;
+	double m_maxSamplePeriod;
+
+	double m_position;
+	double m_velocity;
+	double m_acceleration;
+	double m_prevTimestamp;
+	bool m_hasSample;
+
+	bool Track(double position, double restartVelocity, double timestamp);
+	void Restart(double position, double velocity, double timestamp);
+
+public:
+	VelocityEstimator(double alpha, double measuredVelocityWeight, double maxVelocity, double maxSamplePeriod);
+	virtual ~VelocityEstimator();
+
+	// Timestamps are in seconds. Samples that aren't newer than the last one are ignored
+	void Update(double position, double timestamp);
+	void Update(double position, double measuredVelocity, double timestamp);
+	void Reset();
+
+	double GetPosition();
+	double GetVelocity();
+	double GetAcceleration();
+};
+
+#endif
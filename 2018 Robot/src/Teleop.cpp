@@ -2,7 +2,7 @@
 
 double Robot::GetClosestStepNumber()
 {
-	double currentHeight = ElevatorPID.GetHeightInches();
+	double currentHeight = m_snapshot.elevatorHeight;
 	for(int i = 0; i < consts::NUM_ELEVATOR_SETPOINTS; i++)
 	{
 		// If the elevator is directly below a given setpoint, go to that setpoint
@@ -35,7 +35,7 @@ bool isApproachingMechanicalStop(double output, double currentHeight)
 // Prevent the elevator from reaching its hard stops
 double Robot::CapElevatorOutput(double output, bool safetyModeEnabled)
 {
-	double currentHeight = ElevatorPID.GetHeightInches();
+	double currentHeight = m_snapshot.elevatorHeight;
 
 	// If we're trying to run the elevator down after reaching the bottom or trying
 	// to run it up after reaching the max height, set the motor output to 0
@@ -56,46 +56,50 @@ double Robot::CapElevatorOutput(double output, bool safetyModeEnabled)
 	return output;
 }
 
+// Also called by auto commands, whose first step can run on the GameDataListener thread
 bool Robot::IsElevatorTooHigh()
 {
-	return ElevatorPID.PIDGet() > 12.5;
+	std::lock_guard<std::mutex> lock(m_snapshotMutex);
+	return m_snapshot.elevatorHeight > 12.5;
 }
 
 //Driver Controls
 void Robot::Drive()
 {
+	const ControllerSnapshot& driver = m_snapshot.driveController;
 	double forwardSpeed = 0;
 	double turnSpeed = 0;
 
 	// If they press A, use single stick arcade with the left joystick
-	if(DriveController.GetAButton())
+	if(driver.aButton)
 	{
-		forwardSpeed = DriveController.GetY(GenericHID::JoystickHand::kLeftHand);
-		turnSpeed = DriveController.GetX(GenericHID::JoystickHand::kLeftHand);
+		forwardSpeed = driver.leftY;
+		turnSpeed = driver.leftX;
 	}
 	// If they press the left bumper, use the left joystick for forward and
 	// backward motion and the right joystick for turning
-	else if(DriveController.GetBumper(GenericHID::JoystickHand::kLeftHand))
+	else if(driver.leftBumper)
 	{
-		forwardSpeed = DriveController.GetY(GenericHID::JoystickHand::kLeftHand);
-		turnSpeed = DriveController.GetX(GenericHID::JoystickHand::kRightHand);
+		forwardSpeed = driver.leftY;
+		turnSpeed = driver.rightX;
 	}
 	// If they press the right bumper, use the right joystick for forward and
 	// backward motion and the left joystick for turning
-	else if(DriveController.GetBumper(GenericHID::JoystickHand::kRightHand))
+	else if(driver.rightBumper)
 	{
-		forwardSpeed = DriveController.GetY(GenericHID::JoystickHand::kRightHand);
-		turnSpeed = DriveController.GetX(GenericHID::JoystickHand::kLeftHand);
+		forwardSpeed = driver.rightY;
+		turnSpeed = driver.leftX;
 	}
 
 	// Ensure the robot doesn't drive at full speed while the elevator is up
-	if(IsElevatorTooHigh())
+	bool isElevatorTooHigh = IsElevatorTooHigh();
+	if(isElevatorTooHigh)
 	{
 		forwardSpeed *= consts::DRIVE_SPEED_REDUCTION;
 		turnSpeed *= consts::DRIVE_SPEED_REDUCTION;
 	}
 
-	SmartDashboard::PutBoolean("Drive Speed Reduction?", IsElevatorTooHigh());
+	m_telemetry.SetBoolean(m_telemetrySlots.isDriveSpeedReduced, isElevatorTooHigh);
 
 	// Negative is used to make forward positive and backwards negative
 	// because the y-axes of the XboxController are natively inverted
@@ -108,21 +112,19 @@ void Robot::ManualElevator()
 {
 	// Use the right trigger to manually raise the elevator and
 	// the left trigger to lower the elevator
-	double raiseElevatorOutput = applyDeadband(OperatorController.GetTriggerAxis(
-			GenericHID::JoystickHand::kRightHand));
-	double lowerElevatorOutput = applyDeadband(OperatorController.GetTriggerAxis(
-			GenericHID::JoystickHand::kLeftHand));
+	double raiseElevatorOutput = applyDeadband(m_snapshot.operatorController.rightTrigger);
+	double lowerElevatorOutput = applyDeadband(m_snapshot.operatorController.leftTrigger);
 
 	double elevatorSpeed;
 
-	bool overridesBeingPressed = OperatorController.GetStartButton();
+	bool overridesBeingPressed = m_snapshot.operatorController.startButton;
 //	bool rightBumperJustReleased = m_prevRBumperState && !OperatorController.GetBumper(GenericHID::kRightHand);
 //	bool leftBumperJustReleased = m_prevLBumperState && !OperatorController.GetBumper(GenericHID::kLeftHand);
 //	bool overridesJustReleased = ( (leftBumperJustReleased && !OperatorController.GetBumper(GenericHID::kRightHand)) ||
 //			(rightBumperJustReleased && !OperatorController.GetBumper(GenericHID::kLeftHand)) ||
 //			(rightBumperJustReleased && leftBumperJustReleased));
-	bool overridesJustReleased = OperatorController.GetBackButton();
-	SmartDashboard::PutBoolean("Zeroing Elevator Encoder?", overridesJustReleased);
+	bool overridesJustReleased = m_snapshot.operatorController.backButton;
+	m_telemetry.SetBoolean(m_telemetrySlots.isZeroingElevator, overridesJustReleased);
 //	OperatorController.GetBumperReleased()
 
 	// If the two override keys are being pressed, allow the elevator to move past the predefined stop points
@@ -136,7 +138,8 @@ void Robot::ManualElevator()
 	else if(overridesJustReleased)
 	{
 		elevatorSpeed = 0;
-		RightElevatorMotor.SetSelectedSensorPosition(0, consts::PID_LOOP_ID, consts::TALON_TIMEOUT_MS);
+		// A replay mustn't zero the real encoder
+		if(!m_isReplaying) RightElevatorMotor.SetSelectedSensorPosition(0, consts::PID_LOOP_ID, consts::TALON_TIMEOUT_MS);
 	}
 	else
 	{
@@ -158,9 +161,9 @@ void Robot::ManualElevator()
 	}
 
 	// Test output
-	SmartDashboard::PutBoolean("OverridesPressed", overridesBeingPressed);
-	SmartDashboard::PutBoolean("OverridesReleased", overridesJustReleased);
-	SmartDashboard::PutNumber("Elevator Height", ElevatorPID.PIDGet());
+	m_telemetry.SetBoolean(m_telemetrySlots.areOverridesPressed, overridesBeingPressed);
+	m_telemetry.SetBoolean(m_telemetrySlots.areOverridesReleased, overridesJustReleased);
+	m_telemetry.SetNumber(m_telemetrySlots.elevatorHeight, m_snapshot.elevatorHeight);
 
 //	SmartDashboard::PutBoolean("Left Released", leftBumperJustReleased);
 //	SmartDashboard::PutBoolean("Right Released", rightBumperJustReleased);
@@ -171,13 +174,11 @@ void Robot::Elevator()
 {
 	// Use the right trigger to manually raise the elevator and
 	// the left trigger to lower the elevator
-	double raiseElevatorOutput = applyDeadband(OperatorController.GetTriggerAxis(
-			GenericHID::JoystickHand::kRightHand));
-	double lowerElevatorOutput = applyDeadband(OperatorController.GetTriggerAxis(
-			GenericHID::JoystickHand::kLeftHand));
+	double raiseElevatorOutput = applyDeadband(m_snapshot.operatorController.rightTrigger);
+	double lowerElevatorOutput = applyDeadband(m_snapshot.operatorController.leftTrigger);
 
-	SmartDashboard::PutNumber("RaiseElev", raiseElevatorOutput);
-	SmartDashboard::PutNumber("LowerElev", lowerElevatorOutput);
+	m_telemetry.SetNumber(m_telemetrySlots.raiseElevatorOutput, raiseElevatorOutput);
+	m_telemetry.SetNumber(m_telemetrySlots.lowerElevatorOutput, lowerElevatorOutput);
 
 	// If either triggers are being pressed, disable the PID and
 	// set the motor to the given speed
@@ -195,8 +196,14 @@ void Robot::Elevator()
 		LeftElevatorMotor.Set(0);
 	}
 
-	// Automatic Mode is controlled by both bumpers
-	if (OperatorController.GetBumperPressed(GenericHID::JoystickHand::kRightHand))
+	// Automatic Mode is controlled by both bumpers. Presses are found by comparing the snapshot with
+	// the one from the last call, so a replay sees the same presses as the match did
+	const ControllerSnapshot& operatorController = m_snapshot.operatorController;
+	bool isRightBumperPressed = operatorController.rightBumper && !m_prevOperatorController.rightBumper;
+	bool isLeftBumperPressed = operatorController.leftBumper && !m_prevOperatorController.leftBumper;
+	m_prevOperatorController = operatorController;
+
+	if (isRightBumperPressed)
 	{
 		// If elevator is lowering and the right bumper is pressed, stop elevator where it is
 		if (m_isElevatorLowering)
@@ -224,7 +231,7 @@ void Robot::Elevator()
 		}
 	}
 	// The left bumper will lower the elevator to the bottom
-	if (OperatorController.GetBumperPressed(GenericHID::JoystickHand::kLeftHand))
+	if (isLeftBumperPressed)
 	{
 		m_isElevatorLowering = true;
 		ElevatorPIDController.SetSetpoint(consts::ELEVATOR_SETPOINTS[consts::ElevatorIncrement::GROUND]);
@@ -234,12 +241,13 @@ void Robot::Elevator()
 
 void Robot::Intake()
 {
-	if(OperatorController.GetBumper(GenericHID::JoystickHand::kRightHand))
+	const ControllerSnapshot& operatorController = m_snapshot.operatorController;
+	if(operatorController.rightBumper)
 	{
 		LeftSolenoid.Set(DoubleSolenoid::Value::kReverse);
 		RightSolenoid.Set(DoubleSolenoid::Value::kReverse);
 	}
-	else if(OperatorController.GetBumper(GenericHID::JoystickHand::kLeftHand))
+	else if(operatorController.leftBumper)
 	{
 		RightIntakeMotor.Set(-consts::INTAKE_SPEED);
 		LeftIntakeMotor.Set(consts::INTAKE_SPEED);
@@ -252,12 +260,12 @@ void Robot::Intake()
 			RightSolenoid.Set(DoubleSolenoid::Value::kForward);
 //		}
 	}
-	else if(OperatorController.GetBButton())
+	else if(operatorController.bButton)
 	{
 		RightIntakeMotor.Set(consts::INTAKE_SPEED);
 		LeftIntakeMotor.Set(-consts::INTAKE_SPEED);
 	}
-	else if(OperatorController.GetAButton())
+	else if(operatorController.aButton)
 	{
 		RightIntakeMotor.Set(-consts::INTAKE_SPEED);
 		LeftIntakeMotor.Set(consts::INTAKE_SPEED);
@@ -265,7 +273,7 @@ void Robot::Intake()
 	else
 	{
 		// Use the Right Y-axis for variable intake speed
-		double intakeSpeed = applyDeadband(OperatorController.GetY(GenericHID::kRightHand));
+		double intakeSpeed = applyDeadband(operatorController.rightY);
 		RightIntakeMotor.Set(intakeSpeed);
 		LeftIntakeMotor.Set(-intakeSpeed);
 
@@ -288,18 +296,34 @@ void Robot::Intake()
 void Robot::Linkage()
 {
 	// Use the left y-axis to do the linkage
-	double motorSpeed = -OperatorController.GetY(GenericHID::JoystickHand::kLeftHand);
+	double motorSpeed = -m_snapshot.operatorController.leftY;
 	LinkageMotor.Set(motorSpeed);
 }
 
 void Robot::TeleopInit()
 {
 	StopCurrentProcesses();
+	m_robotMode = TELEOP_MODE;
+	ResetTiming(m_teleopTiming);
+	m_traceName = GetMatchLogName("Teleop");
+	// In a real match teleop keeps recording into the file started in autonomous
+	if(!DriverStation::GetInstance().IsFMSAttached())
+	{
+		m_matchRecorder.Rotate(GetMatchLogName("Teleop"));
+	}
 	LeftSolenoid.Set(DoubleSolenoid::Value::kForward);
 	RightSolenoid.Set(DoubleSolenoid::Value::kForward);
 }
 
 void Robot::TeleopPeriodic()
+{
+	ScopedLoopTimer timing(m_teleopTiming);
+	UpdateSnapshot();
+	TeleopLogic();
+}
+
+// Everything teleop does with one snapshot. A replay runs this on recorded snapshots
+void Robot::TeleopLogic()
 {
 	Drive();
 	ManualElevator();
@@ -2,28 +2,41 @@
 
 void Robot::TestPeriodic()
 {
+	ScopedLoopTimer timing(m_testTiming);
+	UpdateSnapshot();
+
+	m_autoScheduler.Run();
 	AutonomousTest();
+	AutotuneTest();
 }
 
 void Robot::TestInit()
 {
-	SmartDashboard::PutNumber("Elevator Setpoint", 0);
-	SmartDashboard::PutBoolean("Reset Elevator Encoder?", false);
-	SmartDashboard::PutNumber("Elevator P", 0.03);
-	SmartDashboard::PutNumber("Elevator Constant", 0.5);
-	SmartDashboard::PutNumber("Elevator Limit", 0.8);
+	m_dashboardControls.elevatorSetpoint.Reset();
+	m_dashboardControls.resetElevatorEncoder.Reset();
+	m_dashboardControls.elevatorP.Reset();
+	m_dashboardControls.elevatorConstant.Reset();
+	m_dashboardControls.elevatorLimit.Reset();
+	m_dashboardControls.autotuneAngle.Reset();
+	m_dashboardControls.autotuneDistance.Reset();
+	m_dashboardControls.autotuneElevator.Reset();
+	m_dashboardControls.applyAutotunedGains.Reset();
 
 	StopCurrentProcesses();
+	m_robotMode = TEST_MODE;
+	ResetTiming(m_testTiming);
+	m_matchRecorder.Rotate("Test");
+	m_traceName = "Test";
 
-	if(SmartDashboard::GetBoolean("Test Angle", 0))
+	if(m_dashboardControls.testAngle.Get())
 	{
 		TurnAngleTest(0);
 	}
-	else if(SmartDashboard::GetBoolean("Test Maintain", 0))
+	else if(m_dashboardControls.testMaintain.Get())
 	{
 		MaintainHeadingTest();
 	}
-	else if(SmartDashboard::GetBoolean("Test Distance", 0))
+	else if(m_dashboardControls.testDistance.Get())
 	{
 		DriveDistanceTest(0);
 	}
@@ -31,32 +44,32 @@ void Robot::TestInit()
 
 void Robot::TeleopTest()
 {
-	if(SmartDashboard::GetBoolean("Drive", 0)) DriveTest();
-	if(SmartDashboard::GetBoolean("Full Elevator", 0))
+	if(m_dashboardControls.driveTest.Get()) DriveTest();
+	if(m_dashboardControls.fullElevatorTest.Get())
 	{
 		FullElevatorTest();
-		SmartDashboard::PutBoolean("PID Elevator", 0);
-		SmartDashboard::PutBoolean("Manual Elevator", 0);
+		m_dashboardControls.pidElevatorTest.Set(false);
+		m_dashboardControls.manualElevatorTest.Set(false);
 		SmartDashboard::PutNumber("Elevator Height", ElevatorPID.PIDGet());
 	}
-	else if(SmartDashboard::GetBoolean("Full Elevator", 0))
+	else if(m_dashboardControls.fullElevatorTest.Get())
 	{
 		ManualElevatorTest();
-		SmartDashboard::PutBoolean("PID Elevator", 0);
-		SmartDashboard::PutBoolean("Full Elevator", 0);
+		m_dashboardControls.pidElevatorTest.Set(false);
+		m_dashboardControls.fullElevatorTest.Set(false);
 		SmartDashboard::PutNumber("Elevator Height", ElevatorPID.PIDGet());
 	}
-	else if(SmartDashboard::GetBoolean("PID Elevator", 0))
+	else if(m_dashboardControls.pidElevatorTest.Get())
 	{
 		PIDElevatorTest();
-		SmartDashboard::PutBoolean("PID Elevator", 0);
-		SmartDashboard::PutBoolean("Manual Elevator", 0);
+		m_dashboardControls.pidElevatorTest.Set(false);
+		m_dashboardControls.manualElevatorTest.Set(false);
 		SmartDashboard::PutNumber("Elevator Height", ElevatorPID.PIDGet());
 	}
-	if(SmartDashboard::GetBoolean("Manual Elevator", 0)) ManualElevatorTest();
-	if(SmartDashboard::GetBoolean("PID Elevator", 0)) PIDElevatorTest();
+	if(m_dashboardControls.manualElevatorTest.Get()) ManualElevatorTest();
+	if(m_dashboardControls.pidElevatorTest.Get()) PIDElevatorTest();
 	if(SmartDashboard::GetBoolean("Linkage", 0)) LinkageTest();
-	if(SmartDashboard::GetBoolean("Intake", 0)) IntakeTest();
+	if(m_dashboardControls.intakeTest.Get()) IntakeTest();
 }
 
 void Robot::AutonomousTest()
@@ -70,47 +83,44 @@ void Robot::AutonomousTest()
 
 
 	SmartDashboard::PutNumber("Elevator Height", ElevatorPID.PIDGet());
-	if(SmartDashboard::GetBoolean("Reset Elevator Encoder?", false)) {
+	if(m_dashboardControls.resetElevatorEncoder.Get()) {
 		RightElevatorMotor.SetSelectedSensorPosition(0, consts::PID_LOOP_ID, consts::TALON_TIMEOUT_MS);
-		SmartDashboard::PutBoolean("Reset Elevator Encoder?", false);
+		m_dashboardControls.resetElevatorEncoder.Set(false);
 	}
 
-	if(!SmartDashboard::GetBoolean("Go Forward, Turn Right", 0))
+	if(!m_dashboardControls.goForwardTurnRight.Get())
 	{
 		//Reset Angle Button
-		if(SmartDashboard::GetBoolean("Reset Angle", 0))
+		if(m_dashboardControls.resetAngle.Get())
 		{
 			AngleSensors.Reset();
-			SmartDashboard::PutBoolean("Reset Angle", 0);
+			m_dashboardControls.resetAngle.Set(false);
 		}
 		//Reset Encoder Button
-		if(SmartDashboard::GetBoolean("Reset Encoders", 0))
+		if(m_dashboardControls.resetEncoders.Get())
 		{
 			ResetDriveEncoders();
-			SmartDashboard::PutBoolean("Reset Encoders", 0);
+			m_dashboardControls.resetEncoders.Set(false);
 		}
 
 		//Maintain Angle Test Buttons
-		if(SmartDashboard::GetBoolean("Toggle Maintain Test", 0))
+		if(m_dashboardControls.toggleMaintainTest.Get())
 		{
 			//Toggle the two buttons
-			SmartDashboard::PutBoolean("Enable Test Distance Output",
-					SmartDashboard::GetBoolean("Enable Test Distance Output", 0) ^ 1);
-			SmartDashboard::PutBoolean("Enable Maintain Controller",
-					SmartDashboard::GetBoolean("Enable Maintain Controller", 0) ^ 1);
+			m_dashboardControls.enableTestDistanceOutput.Set(!m_dashboardControls.enableTestDistanceOutput.Get());
+			m_dashboardControls.enableMaintainController.Set(!m_dashboardControls.enableMaintainController.Get());
 
-			SmartDashboard::PutBoolean("Toggle Maintain Test", 0);
+			m_dashboardControls.toggleMaintainTest.Set(false);
 		}
-		if(SmartDashboard::GetBoolean("Enable Test Distance Output", 0))
+		if(m_dashboardControls.enableTestDistanceOutput.Get())
 		{
-			AnglePIDOut.SetTestDistOutput(SmartDashboard::GetNumber(
-					"Test Maintain Output", 0));
+			AnglePIDOut.SetTestDistOutput(m_dashboardControls.testMaintainOutput.Get());
 		}
 		else
 		{
 			AnglePIDOut.SetTestDistOutput(0);
 		}
-		if(SmartDashboard::GetBoolean("Enable Maintain Controller", 0))
+		if(m_dashboardControls.enableMaintainController.Get())
 		{
 			MaintainAngleController.Enable();
 		}
@@ -119,22 +129,22 @@ void Robot::AutonomousTest()
 			if(MaintainAngleController.IsEnabled()) MaintainAngleController.Disable();
 		}
 	}
-	if(SmartDashboard::GetBoolean("Test Distance", 0))
+	if(m_dashboardControls.testDistance.Get())
 	{
-		if(SmartDashboard::GetBoolean("Toggle Distance Test", 0))
+		if(m_dashboardControls.toggleDistanceTest.Get())
 		{
-			SmartDashboard::PutBoolean("Enable Maintain Controller", 1);
+			m_dashboardControls.enableMaintainController.Set(true);
 			MaintainAngleController.Enable();
 			DistanceController.Enable();
 		}
 		else
 		{
-			SmartDashboard::PutBoolean("Enable Maintain Controller", 0);
+			m_dashboardControls.enableMaintainController.Set(false);
 			DistanceController.Disable();
 			MaintainAngleController.Disable();
 		}
 	}
-	else if(SmartDashboard::GetBoolean("Test Auto Elevator", 0))
+	else if(m_dashboardControls.testAutoElevator.Get())
 	{
 		AutoElevatorTest();
 	}
@@ -162,10 +172,6 @@ void Robot::MaintainHeadingTest()
 	//Enable test dist output
 	AnglePIDOut.SetTestDistOutput(0.35);
 
-	//Remove the pointers since only one PID is being used
-	DistancePID.SetAnglePID(nullptr);
-	AnglePIDOut.SetDistancePID(nullptr);
-
 	//Configure the PID controller to make sure the robot drives straight with the NavX
 	MaintainAngleController.Reset();
 	MaintainAngleController.SetSetpoint(0);
@@ -184,9 +190,6 @@ void Robot::DriveDistanceTest(double distance)
 
 	//Disable test dist output for angle
 	AnglePIDOut.SetTestDistOutput(0);
-	//Make sure the PID objects know about each other to avoid conflicts
-	DistancePID.SetAnglePID(&AnglePIDOut);
-	AnglePIDOut.SetDistancePID(&DistancePID);
 
 	//Configure the PID controller to make sure the robot drives straight with the NavX
 	MaintainAngleController.Reset();
@@ -213,10 +216,6 @@ void Robot::TurnAngleTest(double angle)
 	//Disable test dist output for angle
 	AnglePIDOut.SetTestDistOutput(0);
 
-	//Remove the pointers since only one PID is being used
-	DistancePID.SetAnglePID(nullptr);
-	AnglePIDOut.SetDistancePID(nullptr);
-
 	AngleController.Reset();
 	AngleController.SetSetpoint(angle);
 	AngleController.Enable();
@@ -280,7 +279,7 @@ void Robot::ManualElevatorTest()
 	{
 		ElevatorPIDController.Disable();
 		double output = CapElevatorOutput(dabs(raiseElevatorOutput) - dabs(lowerElevatorOutput),
-				SmartDashboard::GetBoolean("Toggle Elevator Safety", 0));
+				m_dashboardControls.toggleElevatorSafety.Get());
 		RightElevatorMotor.Set(output);
 		LeftElevatorMotor.Set(output);
 		return;
@@ -324,19 +323,20 @@ void Robot::PIDElevatorTest()
 	{
 		// Output ranges from -1 to 1 and will act as a multiplier for the max increment
 		double output = CapElevatorOutput(dabs(raiseElevatorOutput) - dabs(lowerElevatorOutput));
+		units::Inches increment = consts::ELEVATOR_MANUAL_SPEED * units::Seconds(consts::ROBOT_PERIOD_S) * output;
 
 		// If the elevator is in automatic mode, turn it off, and set the desired height to
 		// the current height plus some increment
 		if(m_isElevatorInAutoMode)
 		{
 			m_isElevatorInAutoMode = false;
-			double desiredSetpoint = ElevatorPID.GetHeightInches() + consts::ELEVATOR_INCREMENT_PER_CYCLE * output;
+			double desiredSetpoint = ElevatorPID.GetHeightInches() + increment.Value();
 			CapElevatorSetpoint(desiredSetpoint);
 			ElevatorPIDController.SetSetpoint(desiredSetpoint);
 		}
 		else // If automatic mode isn't on, just increment the previous setpoint
 		{
-			double desiredSetpoint = ElevatorPIDController.GetSetpoint() + consts::ELEVATOR_INCREMENT_PER_CYCLE * output;
+			double desiredSetpoint = ElevatorPIDController.GetSetpoint() + increment.Value();
 			CapElevatorSetpoint(desiredSetpoint);
 			ElevatorPIDController.SetSetpoint(desiredSetpoint);
 		}
@@ -387,7 +387,7 @@ void Robot::PIDElevatorTest()
 	SmartDashboard::PutBoolean("Lowering?", m_isElevatorLowering);
 	SmartDashboard::PutBoolean("Automatic?", m_isElevatorInAutoMode);
 	SmartDashboard::PutNumber("Elevator Height", ElevatorPID.GetHeightInches());
-	SmartDashboard::PutNumber("Elevator Setpoint", ElevatorPIDController.GetSetpoint());
+	m_dashboardControls.elevatorSetpoint.Set(ElevatorPIDController.GetSetpoint());
 	SmartDashboard::PutNumber("Elevator Output", ElevatorPIDController.Get());
 }
 
@@ -409,7 +409,7 @@ void Robot::FullElevatorTest()
 	{
 		ElevatorPIDController.Disable();
 		double output = CapElevatorOutput(dabs(raiseElevatorOutput) - dabs(lowerElevatorOutput),
-				SmartDashboard::GetBoolean("Toggle Elevator Safety", 0));
+				m_dashboardControls.toggleElevatorSafety.Get());
 		RightElevatorMotor.Set(output);
 		LeftElevatorMotor.Set(output);
 		return;
@@ -466,7 +466,7 @@ void Robot::AutoElevatorTest()
 //		ElevatorPIDController.SetSetpoint(SmartDashboard::GetNumber("Desired Increment", 0));
 //	}
 
-		double elevatorHeight = SmartDashboard::GetNumber("Elevator Setpoint", 0);
+		double elevatorHeight = m_dashboardControls.elevatorSetpoint.Get();
 		if(dabs(elevatorHeight - ElevatorPID.PIDGet()) > consts::ELEVATOR_PID_DEADBAND)
 		{
 			double error = elevatorHeight - ElevatorPID.PIDGet();
@@ -483,10 +483,10 @@ void Robot::AutoElevatorTest()
 				SmartDashboard::PutBoolean("Elev On Target?", false);
 				//To avoid damage, use basic p-control with an added constant output speed of 0.5
 				error = elevatorHeight - ElevatorPID.PIDGet();
-				RightElevatorMotor.Set(limit(error * SmartDashboard::GetNumber("Elevator P", 0) +
-						SmartDashboard::GetNumber("Elevator Constant", 0), SmartDashboard::GetNumber("Elevator Limit", 0)));
-				LeftElevatorMotor.Set(limit(error * SmartDashboard::GetNumber("Elevator P", 0) +
-						SmartDashboard::GetNumber("Elevator Constant", 0), SmartDashboard::GetNumber("Elevator Limit", 0)));
+				RightElevatorMotor.Set(limit(error * m_dashboardControls.elevatorP.Get() +
+						m_dashboardControls.elevatorConstant.Get(), m_dashboardControls.elevatorLimit.Get()));
+				LeftElevatorMotor.Set(limit(error * m_dashboardControls.elevatorP.Get() +
+						m_dashboardControls.elevatorConstant.Get(), m_dashboardControls.elevatorLimit.Get()));
 
 				SmartDashboard::PutNumber("Elevator Height", ElevatorPID.PIDGet());
 			}
@@ -496,15 +496,18 @@ void Robot::AutoElevatorTest()
 			RightElevatorMotor.Set(0.25);
 			LeftElevatorMotor.Set(0.25);
 		}
-		EjectCube(consts::INTAKE_SPEED / 2.);
-
 
 		SmartDashboard::PutBoolean("Elev On Target?", true);
-		SmartDashboard::PutBoolean("Test Auto Elevator", false);
+		m_dashboardControls.testAutoElevator.Set(false);
 
-		// ElevatorMotors reset to 0
-		RightElevatorMotor.Set(0);
-		LeftElevatorMotor.Set(0);
+		// Eject the cube from TestPeriodic and only then reset the ElevatorMotors to 0
+		auto ejectTest = std::make_unique<AutoSequence>();
+		ejectTest->Add(EjectCube(consts::INTAKE_SPEED / 2.));
+		ejectTest->Add(std::make_unique<InstantCommand>([this]() {
+			RightElevatorMotor.Set(0);
+			LeftElevatorMotor.Set(0);
+		}));
+		m_autoScheduler.Start(std::move(ejectTest));
 }
 
 void Robot::IntakeTest()
@@ -546,3 +549,80 @@ void Robot::CurrentTest()
 	SmartDashboard::PutNumber("RIntake Current", RightIntakeMotor.GetOutputCurrent());
 	SmartDashboard::PutNumber("LIntake Current", LeftIntakeMotor.GetOutputCurrent());
 }
+
+// Autotune buttons: each one starts a relay experiment on its loop, and the proposed gains are
+// shown on the dashboard until "Apply Autotuned Gains" copies them into the loop
+void Robot::AutotuneTest()
+{
+	if(m_dashboardControls.autotuneAngle.Get())
+	{
+		m_dashboardControls.autotuneAngle.Set(false);
+		m_autoScheduler.Start(Autotune("Angle", AngleController, AnglePIDOut,
+				consts::AUTOTUNE_TURN_AMPLITUDE, consts::AUTOTUNE_TURN_HYSTERESIS, consts::AUTOTUNE_TURN_SETTLE_TIME));
+	}
+	else if(m_dashboardControls.autotuneDistance.Get())
+	{
+		m_dashboardControls.autotuneDistance.Set(false);
+		m_autoScheduler.Start(Autotune("Distance", DistanceController, DistancePID,
+				consts::AUTOTUNE_DRIVE_AMPLITUDE, consts::AUTOTUNE_DRIVE_HYSTERESIS, consts::AUTOTUNE_DRIVE_SETTLE_TIME));
+	}
+	else if(m_dashboardControls.autotuneElevator.Get())
+	{
+		// The relay switches around the gravity feedforward so the elevator oscillates in place
+		m_dashboardControls.autotuneElevator.Set(false);
+		m_autoScheduler.Start(Autotune("Elevator", ElevatorPIDController, ElevatorPID,
+				consts::AUTOTUNE_ELEVATOR_AMPLITUDE, consts::AUTOTUNE_ELEVATOR_HYSTERESIS, consts::AUTOTUNE_ELEVATOR_SETTLE_TIME,
+				[this]() { return ElevatorPID.GetFeedforward(); }));
+	}
+
+	if(m_dashboardControls.applyAutotunedGains.Get())
+	{
+		m_dashboardControls.applyAutotunedGains.Set(false);
+		if(m_autotunedLoop != nullptr)
+		{
+			m_autotunedLoop->SetPID(m_autotunedGains.p, m_autotunedGains.i, m_autotunedGains.d);
+		}
+	}
+}
+
+// Runs a relay experiment around wherever the mechanism is when it starts. The loop is disabled
+// for the experiment, so the relay output goes straight to the loop's output
+AutoCommandPtr Robot::Autotune(std::string name, ControlLoop& loop, PIDOutput& output,
+		double amplitude, double hysteresis, double settleTime, std::function<double()> getBias)
+{
+	auto tuner = std::make_shared<RelayAutotuner>();
+	auto prevTime = std::make_shared<double>(0);
+
+	return std::make_unique<FunctionCommand>(
+		[this, name, tuner, prevTime, &loop, amplitude, hysteresis, getBias]() {
+			SmartDashboard::PutString("Autotune Status", "Autotuning " + name + "...");
+			loop.Disable();
+			*prevTime = Timer::GetFPGATimestamp();
+			tuner->Start(loop.GetSource().PIDGet(), amplitude, hysteresis, consts::AUTOTUNE_CYCLES,
+					getBias ? getBias() : 0);
+		},
+		[tuner, prevTime, &loop, &output]() {
+			double time = Timer::GetFPGATimestamp();
+			output.PIDWrite(tuner->Update(loop.GetSource().PIDGet(), time - *prevTime));
+			*prevTime = time;
+		},
+		[tuner]() { return tuner->IsFinished(); },
+		[this, name, tuner, &loop, &output, settleTime]() {
+			output.PIDWrite(0);
+			if(!tuner->IsFinished())
+			{
+				SmartDashboard::PutString("Autotune Status", name + " autotune didn't finish");
+				return;
+			}
+
+			m_autotunedLoop = &loop;
+			m_autotunedGains = tuner->ProposeGains(settleTime);
+			SmartDashboard::PutNumber("Autotune Ku", tuner->GetUltimateGain());
+			SmartDashboard::PutNumber("Autotune Tu", tuner->GetUltimatePeriod());
+			SmartDashboard::PutNumber("Autotune P", m_autotunedGains.p);
+			SmartDashboard::PutNumber("Autotune I", m_autotunedGains.i);
+			SmartDashboard::PutNumber("Autotune D", m_autotunedGains.d);
+			SmartDashboard::PutString("Autotune Status", name + " autotune finished");
+		},
+		consts::AUTOTUNE_TIMEOUT_S);
+}
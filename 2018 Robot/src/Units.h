@@ -0,0 +1,107 @@
+#ifndef UNITS
+#define UNITS
+
+#include <type_traits>
+
+// Compile-time units for the values that get converted between the sensors and the robot logic.
+// A Quantity is a double tagged with the power of each base unit, so adding inches to degrees or
+// passing ticks where inches are expected doesn't compile. Everything is constexpr and a Quantity
+// is just a double, so conversions between constants fold at compile time and the rest of the math
+// costs the same as it did with plain doubles.
+// - The base units are inches, degrees, encoder ticks, seconds and volts
+// - Value() gives back the plain double to hand to WPILib and the Talons
+namespace units
+{
+	template<int INCHES, int DEGREES, int TICKS, int SECONDS, int VOLTS>
+	class Quantity
+	{
+	private:
+		double m_value;
+
+	public:
+		constexpr Quantity() : m_value(0) {}
+		constexpr explicit Quantity(double value) : m_value(value) {}
+
+		constexpr double Value() const { return m_value; }
+
+		constexpr Quantity operator+(Quantity other) const { return Quantity(m_value + other.m_value); }
+		constexpr Quantity operator-(Quantity other) const { return Quantity(m_value - other.m_value); }
+		constexpr Quantity operator-() const { return Quantity(-m_value); }
+		constexpr Quantity operator*(double scale) const { return Quantity(m_value * scale); }
+		constexpr Quantity operator/(double scale) const { return Quantity(m_value / scale); }
+
+		Quantity& operator+=(Quantity other) { m_value += other.m_value; return *this; }
+		Quantity& operator-=(Quantity other) { m_value -= other.m_value; return *this; }
+
+		constexpr bool operator<(Quantity other) const { return m_value < other.m_value; }
+		constexpr bool operator>(Quantity other) const { return m_value > other.m_value; }
+		constexpr bool operator<=(Quantity other) const { return m_value <= other.m_value; }
+		constexpr bool operator>=(Quantity other) const { return m_value >= other.m_value; }
+		constexpr bool operator==(Quantity other) const { return m_value == other.m_value; }
+		constexpr bool operator!=(Quantity other) const { return m_value != other.m_value; }
+	};
+
+	template<int I, int D, int T, int S, int V>
+	constexpr Quantity<I, D, T, S, V> operator*(double scale, Quantity<I, D, T, S, V> quantity)
+	{
+		return quantity * scale;
+	}
+
+	template<int I, int D, int T, int S, int V>
+	constexpr Quantity<-I, -D, -T, -S, -V> operator/(double scale, Quantity<I, D, T, S, V> quantity)
+	{
+		return Quantity<-I, -D, -T, -S, -V>(scale / quantity.Value());
+	}
+
+	// Multiplying and dividing quantities adds and subtracts the powers of their units
+	template<int I1, int D1, int T1, int S1, int V1, int I2, int D2, int T2, int S2, int V2>
+	constexpr Quantity<I1 + I2, D1 + D2, T1 + T2, S1 + S2, V1 + V2>
+	operator*(Quantity<I1, D1, T1, S1, V1> a, Quantity<I2, D2, T2, S2, V2> b)
+	{
+		return Quantity<I1 + I2, D1 + D2, T1 + T2, S1 + S2, V1 + V2>(a.Value() * b.Value());
+	}
+
+	template<int I1, int D1, int T1, int S1, int V1, int I2, int D2, int T2, int S2, int V2>
+	constexpr Quantity<I1 - I2, D1 - D2, T1 - T2, S1 - S2, V1 - V2>
+	operator/(Quantity<I1, D1, T1, S1, V1> a, Quantity<I2, D2, T2, S2, V2> b)
+	{
+		return Quantity<I1 - I2, D1 - D2, T1 - T2, S1 - S2, V1 - V2>(a.Value() / b.Value());
+	}
+
+	typedef Quantity<0, 0, 0, 0, 0> Scalar;
+	typedef Quantity<1, 0, 0, 0, 0> Inches;
+	typedef Quantity<0, 1, 0, 0, 0> Degrees;
+	typedef Quantity<0, 0, 1, 0, 0> Ticks;
+	typedef Quantity<0, 0, 0, 1, 0> Seconds;
+	typedef Quantity<0, 0, 0, 0, 1> Volts;
+
+	typedef Quantity<1, 0, 0, -1, 0> InchesPerSecond;
+	typedef Quantity<1, 0, 0, -2, 0> InchesPerSecondSquared;
+	typedef Quantity<0, 1, 0, -1, 0> DegreesPerSecond;
+	typedef Quantity<0, 0, 0, -1, 0> PerSecond;
+	typedef Quantity<1, 0, -1, 0, 0> InchesPerTick;
+	typedef Quantity<-1, 0, 1, 0, 0> TicksPerInch;
+
+	static_assert(sizeof(Inches) == sizeof(double) && std::is_trivially_copyable<Inches>::value,
+			"A Quantity must cost no more than the double it wraps");
+
+	// The Talons report velocities in ticks per 100ms
+	constexpr Seconds TALON_VELOCITY_PERIOD(0.1);
+
+	namespace literals
+	{
+		constexpr Inches operator"" _in(long double value) { return Inches(value); }
+		constexpr Inches operator"" _in(unsigned long long value) { return Inches(value); }
+		constexpr Degrees operator"" _deg(long double value) { return Degrees(value); }
+		constexpr Degrees operator"" _deg(unsigned long long value) { return Degrees(value); }
+		constexpr Ticks operator"" _ticks(unsigned long long value) { return Ticks(value); }
+		constexpr Seconds operator"" _s(long double value) { return Seconds(value); }
+		constexpr Seconds operator"" _s(unsigned long long value) { return Seconds(value); }
+		constexpr Seconds operator"" _ms(long double value) { return Seconds(value / 1000); }
+		constexpr Seconds operator"" _ms(unsigned long long value) { return Seconds(value / 1000.); }
+		constexpr Volts operator"" _V(long double value) { return Volts(value); }
+		constexpr Volts operator"" _V(unsigned long long value) { return Volts(value); }
+	}
+}
+
+#endif
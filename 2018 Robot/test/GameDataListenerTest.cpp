@@ -0,0 +1,129 @@
+#include "HostTest.h"
+#include <Auto/GameDataListener.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Stands in for the driver station: every packet wakes the threads waiting for data, and the
+// game specific message is whatever the last packet carried
+class DriverStationStandIn
+{
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_newData;
+	unsigned int m_numPackets;
+	std::string m_gameData;
+
+public:
+	DriverStationStandIn() :
+		m_numPackets(0),
+		m_gameData()
+	{
+
+	}
+
+	void SendPacket(std::string gameData)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_numPackets++;
+			m_gameData = gameData;
+		}
+		m_newData.notify_all();
+	}
+
+	bool WaitForData(double timeout)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		unsigned int numPackets = m_numPackets;
+		return m_newData.wait_for(lock, std::chrono::duration<double>(timeout),
+				[&]() { return m_numPackets != numPackets; });
+	}
+
+	std::string GetGameSpecificMessage()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_gameData;
+	}
+};
+
+// Stands in for the first motor command of the auto plan, which Robot::OnGameData sends
+struct FirstCommand
+{
+	std::mutex mutex;
+	std::condition_variable sent;
+	int numSent = 0;
+	std::string gameData;
+	Clock::time_point time;
+};
+
+static bool WaitForCommand(FirstCommand& command, int numSent)
+{
+	std::unique_lock<std::mutex> lock(command.mutex);
+	return command.sent.wait_for(lock, std::chrono::seconds(1), [&]() { return command.numSent >= numSent; });
+}
+
+int main()
+{
+	DriverStationStandIn driverStation;
+	FirstCommand command;
+	GameDataListener listener(
+		[&](std::string gameData) {
+			std::lock_guard<std::mutex> lock(command.mutex);
+			command.time = Clock::now();
+			command.gameData = gameData;
+			command.numSent++;
+			command.sent.notify_all();
+		},
+		[&](double timeout) { return driverStation.WaitForData(timeout); },
+		[&]() { return driverStation.GetGameSpecificMessage(); });
+	listener.Start();
+
+	// A disarmed listener ignores the game data
+	driverStation.SendPacket("LRL");
+	CHECK(!WaitForCommand(command, 1));
+
+	// Packets without game data don't count, and the data is only reported once per Arm()
+	driverStation.SendPacket("");
+	listener.Arm();
+	driverStation.SendPacket("");
+	driverStation.SendPacket("RLR");
+	CHECK(WaitForCommand(command, 1));
+	driverStation.SendPacket("RLR");
+	CHECK(!WaitForCommand(command, 2));
+	CHECK(command.gameData == "RLR");
+
+	// Arrival to first motor command. Polling from the robot loop costs up to a whole 20ms
+	// robot period, so the listener has to stay well under that
+	std::vector<double> latencies;
+	for(int i = 0; i < 50; i++)
+	{
+		listener.Arm();
+		driverStation.SendPacket("");   // Make sure the listener is back to waiting
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+		Clock::time_point arrival = Clock::now();
+		driverStation.SendPacket("LLR");
+		CHECK(WaitForCommand(command, 2 + i));
+
+		std::lock_guard<std::mutex> lock(command.mutex);
+		latencies.push_back(std::chrono::duration<double, std::milli>(command.time - arrival).count());
+	}
+	std::sort(latencies.begin(), latencies.end());
+	double median = latencies[latencies.size() / 2];
+	double worst = latencies.back();
+	std::printf("Game data to first command: median %.3fms, worst %.3fms\n", median, worst);
+	CHECK(median < 2);
+	CHECK(worst < 10);
+
+	// Stopping while the thread waits for a packet returns within the wait timeout
+	Clock::time_point stopStart = Clock::now();
+	listener.Stop();
+	CHECK(Clock::now() - stopStart < std::chrono::milliseconds(500));
+
+	return FinishTest("GameDataListenerTest");
+}
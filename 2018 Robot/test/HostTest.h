@@ -0,0 +1,39 @@
+#ifndef HOST_TEST
+#define HOST_TEST
+
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal checks for the host tests. These build with g++ on a Linux machine, without WPILib,
+// against the parts of src that don't depend on it (see the Makefile)
+static int g_numFailures = 0;
+
+#define CHECK(condition) \
+	do { \
+		if(!(condition)) \
+		{ \
+			std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			g_numFailures++; \
+		} \
+	} while(0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+	do { \
+		double actualValue = (actual); \
+		double expectedValue = (expected); \
+		if(!(actualValue >= expectedValue - (tolerance) && actualValue <= expectedValue + (tolerance))) \
+		{ \
+			std::printf("%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g\n", __FILE__, __LINE__, \
+					#actual, #expected, actualValue, expectedValue); \
+			g_numFailures++; \
+		} \
+	} while(0)
+
+inline int FinishTest(const char* name)
+{
+	if(g_numFailures == 0) std::printf("%s passed\n", name);
+	else                   std::printf("%s: %d checks failed\n", name, g_numFailures);
+	return g_numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#endif
@@ -0,0 +1,101 @@
+#include "HostTest.h"
+#include <Constants.h>
+#include <PID/RelayAutotuner.h>
+#include <cmath>
+#include <deque>
+
+// An integrator with a delay, y' = K * (u(t - L) - bias), like the drive, turn and elevator
+// (the bias is the elevator's gravity feedforward). Steps of 1ms keep the sampling small next
+// to the delay, so the relay oscillation matches the analytic one
+struct IntegratorPlant
+{
+	double gain;
+	double delay;
+	double bias;
+	double position;
+	std::deque<double> outputs;
+
+	static constexpr double PERIOD_S = 0.001;
+
+	IntegratorPlant(double gain, double delay, double bias) :
+		gain(gain),
+		delay(delay),
+		bias(bias),
+		position(0),
+		outputs((size_t)std::lround(delay / PERIOD_S), bias)
+	{
+
+	}
+
+	void Step(double output)
+	{
+		outputs.push_back(output);
+		position += gain * (outputs.front() - bias) * PERIOD_S;
+		outputs.pop_front();
+	}
+};
+
+static void RunExperiment(RelayAutotuner& tuner, IntegratorPlant& plant, double amplitude, double hysteresis)
+{
+	tuner.Start(plant.position, amplitude, hysteresis, consts::AUTOTUNE_CYCLES, plant.bias);
+	for(int i = 0; i < 30000 && !tuner.IsFinished(); i++)
+	{
+		plant.Step(tuner.Update(plant.position, IntegratorPlant::PERIOD_S));
+	}
+}
+
+// The relay ramps the plant at K * d, and each switch only reaches it L later, so the plant
+// overshoots the hysteresis band by K * d * L: a = h + K * d * L and Tu = 4 * a / (K * d).
+// Ku is the describing function gain 4d / (pi * a), with a corrected for the band
+static void CheckExperiment(double gain, double delay, double bias, double amplitude, double hysteresis)
+{
+	IntegratorPlant plant(gain, delay, bias);
+	RelayAutotuner tuner;
+	RunExperiment(tuner, plant, amplitude, hysteresis);
+	CHECK(tuner.IsFinished());
+	CHECK(tuner.GetMeasuredCycles() == consts::AUTOTUNE_CYCLES);
+
+	double oscillation = hysteresis + gain * amplitude * delay;
+	double ultimatePeriod = 4 * oscillation / (gain * amplitude);
+	double ultimateGain = 4 * amplitude / (consts::PI * std::sqrt(oscillation * oscillation - hysteresis * hysteresis));
+	std::printf("K %g, L %g, d %g, h %g: Ku %.4f (expected %.4f), Tu %.4f (expected %.4f)\n",
+			gain, delay, amplitude, hysteresis,
+			tuner.GetUltimateGain(), ultimateGain, tuner.GetUltimatePeriod(), ultimatePeriod);
+	CHECK_NEAR(tuner.GetUltimatePeriod(), ultimatePeriod, ultimatePeriod * 0.03);
+	CHECK_NEAR(tuner.GetUltimateGain(), ultimateGain, ultimateGain * 0.03);
+}
+
+int main()
+{
+	// Without a hysteresis band, Tu = 4L, which is the delay ProposeGains() assumes
+	CheckExperiment(60, 0.05, 0, 0.15, 0);
+	CheckExperiment(200, 0.1, 0, 0.3, 0);
+
+	// The elevator experiment, around its gravity feedforward
+	CheckExperiment(1 / consts::ELEVATOR_GAINS_RISING[2][consts::ELEVATOR_KV], 0.05,
+			consts::ELEVATOR_GAINS_RISING[2][consts::ELEVATOR_KG],
+			consts::AUTOTUNE_ELEVATOR_AMPLITUDE, consts::AUTOTUNE_ELEVATOR_HYSTERESIS);
+
+	// The turn experiment, on a drive that turns at 300 degrees per second at full output
+	CheckExperiment(300, 0.08, 0, consts::AUTOTUNE_TURN_AMPLITUDE, consts::AUTOTUNE_TURN_HYSTERESIS);
+
+	// The relay holds the bias once it's finished, and the proposed gains are usable
+	IntegratorPlant plant(60, 0.05, 0.1);
+	RelayAutotuner tuner;
+	RunExperiment(tuner, plant, 0.15, 0);
+	CHECK(tuner.Update(plant.position, IntegratorPlant::PERIOD_S) == 0.1);
+	CHECK_NEAR(tuner.GetUltimatePeriod() / 4, 0.05, 0.05 * 0.03);
+	PIDGains gains = tuner.ProposeGains(consts::AUTOTUNE_ELEVATOR_SETTLE_TIME);
+	CHECK(gains.p > 0 && gains.p < tuner.GetUltimateGain());
+	CHECK(gains.i > 0);
+	CHECK(gains.d == 0);
+
+	// Nothing is measured before the experiment runs
+	RelayAutotuner idleTuner;
+	CHECK(idleTuner.GetUltimateGain() == 0);
+	CHECK(idleTuner.GetUltimatePeriod() == 0);
+	PIDGains idleGains = idleTuner.ProposeGains(1);
+	CHECK(idleGains.p == 0 && idleGains.i == 0 && idleGains.d == 0);
+
+	return FinishTest("RelayAutotunerTest");
+}
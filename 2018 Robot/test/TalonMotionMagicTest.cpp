@@ -0,0 +1,161 @@
+#include "HostTest.h"
+#include <Constants.h>
+#include <Control/TalonMotionMagic.h>
+#include <algorithm>
+#include <cmath>
+
+static const double PULSES_PER_INCH = (1 / consts::ELEVATOR_INCHES_PER_TICK).Value();
+static const double KG = consts::ELEVATOR_GAINS_RISING[2][consts::ELEVATOR_KG];
+static const double KV = consts::ELEVATOR_GAINS_RISING[2][consts::ELEVATOR_KV];
+
+// A model of the Talon's 1kHz Motion Magic loop running the elevator, from what the stand-in
+// Talon was configured with and sent. The carriage needs KG to hold against gravity and reaches
+// 1 / KV inches per second per unit of output above that after a short lag
+class OnboardElevatorModel
+{
+private:
+	WPI_TalonSRX& m_talon;
+	double m_target;             // Pulses
+	double m_profilePosition;    // Pulses
+	double m_profileVelocity;    // Pulses per second
+	double m_lastError;
+
+	static constexpr double PERIOD_S = 0.001;
+	static constexpr double LAG_S = 0.05;
+
+public:
+	double position;    // Inches
+	double velocity;    // Inches per second
+
+	OnboardElevatorModel(WPI_TalonSRX& talon) :
+		m_talon(talon),
+		m_target(0),
+		m_profilePosition(0),
+		m_profileVelocity(0),
+		m_lastError(0),
+		position(0),
+		velocity(0)
+	{
+
+	}
+
+	void Step()
+	{
+		double output = 0;
+		if(m_talon.GetControlMode() == ControlMode::MotionMagic)
+		{
+			// A new target carries on from wherever the profile is
+			m_target = m_talon.demand;
+
+			double maxVelocity = m_talon.cruiseVelocity * 10.;
+			double maxAcceleration = m_talon.acceleration * 10.;
+			// Heads for the target at up to the cruise velocity, slowing so it can stop there
+			double remaining = m_target - m_profilePosition;
+			double step = maxAcceleration * PERIOD_S;
+			double velocity = std::min(maxVelocity, std::sqrt(2 * maxAcceleration * std::fabs(remaining)));
+			if(remaining < 0) velocity = -velocity;
+			m_profileVelocity = std::max(m_profileVelocity - step, std::min(m_profileVelocity + step, velocity));
+			if(std::fabs(remaining) <= std::fabs(m_profileVelocity) * PERIOD_S)
+			{
+				m_profilePosition = m_target;
+				m_profileVelocity = 0;
+			}
+			else
+			{
+				m_profilePosition += m_profileVelocity * PERIOD_S;
+			}
+
+			const WPI_TalonSRX::SlotGains& gains = m_talon.slots[m_talon.selectedSlot];
+			double error = m_profilePosition - position * PULSES_PER_INCH;
+			output = (gains.kP * error + gains.kD * (error - m_lastError) + gains.kF * m_profileVelocity / 10)
+					/ 1023 + m_talon.arbitraryFeedForward;
+			output = std::max(-1., std::min(1., output));
+			m_lastError = error;
+			m_talon.closedLoopError = (int)(m_target - position * PULSES_PER_INCH);
+		}
+		else
+		{
+			m_profilePosition = position * PULSES_PER_INCH;
+			m_profileVelocity = velocity * PULSES_PER_INCH;
+			m_lastError = 0;
+		}
+
+		velocity += ((output - KG) / KV - velocity) * PERIOD_S / LAG_S;
+		position += velocity * PERIOD_S;
+	}
+};
+
+int main()
+{
+	WPI_TalonSRX leader;
+	WPI_TalonSRX follower;
+	TalonMotionMagic motionMagic(leader, &follower, PULSES_PER_INCH);
+	motionMagic.Configure(consts::ELEVATOR_ONBOARD_P, 0.02, KV,
+			consts::ELEVATOR_MAX_VELOCITY, consts::ELEVATOR_MAX_ACCELERATION);
+
+	// The native gains give the same output as the roboRIO gains: P for an inch of error, D for an
+	// error changing by an inch per second (the roboRIO sees 50ms of that, the Talon 1ms) and kV
+	// at a velocity of an inch per second
+	const WPI_TalonSRX::SlotGains& gains = leader.slots[leader.selectedSlot];
+	CHECK(leader.selectedSlot == consts::MOTION_MAGIC_SLOT);
+	CHECK_NEAR(gains.kP * PULSES_PER_INCH / 1023, consts::ELEVATOR_ONBOARD_P, 1e-9);
+	CHECK_NEAR(gains.kD * PULSES_PER_INCH * 0.001 / 1023, 0.02 * consts::PID_GAIN_PERIOD_S, 1e-9);
+	CHECK_NEAR(gains.kF * PULSES_PER_INCH / 10 / 1023, KV, 1e-9);
+	CHECK(gains.kI == 0);
+	CHECK_NEAR(leader.cruiseVelocity / PULSES_PER_INCH * 10, consts::ELEVATOR_MAX_VELOCITY, 0.02);
+	CHECK_NEAR(leader.acceleration / PULSES_PER_INCH * 10, consts::ELEVATOR_MAX_ACCELERATION, 0.02);
+
+	// The first target puts the follower in follower mode and sends one frame in pulses
+	CHECK(!motionMagic.IsActive());
+	motionMagic.SetTarget(40, KG);
+	CHECK(motionMagic.IsActive());
+	CHECK(leader.numFrames == 1);
+	CHECK_NEAR(leader.demand, 40 * PULSES_PER_INCH, 1e-6);
+	CHECK_NEAR(leader.arbitraryFeedForward, KG, 1e-9);
+	CHECK(follower.GetControlMode() == ControlMode::Follower && follower.leader == &leader);
+
+	// Repeating the target, or moving the feedforward by less than the threshold, sends nothing
+	motionMagic.SetTarget(40, KG);
+	motionMagic.SetTarget(40, KG + 0.005);
+	CHECK(leader.numFrames == 1);
+	motionMagic.SetTarget(40, KG + 0.02);
+	CHECK(leader.numFrames == 2);
+	motionMagic.SetTarget(40, KG);
+	CHECK(leader.numFrames == 3);
+
+	// The model follows the trapezoid to the target: 0.5s to cruise, 0.39s at cruise and 0.5s to stop
+	OnboardElevatorModel model(leader);
+	double maxPosition = 0;
+	for(int i = 0; i < 2000; i++)
+	{
+		model.Step();
+		maxPosition = std::max(maxPosition, model.position);
+		motionMagic.SetTarget(40, KG);
+	}
+	CHECK(leader.numFrames == 3);
+	CHECK_NEAR(model.position, 40, 0.5);
+	CHECK(maxPosition < 40 + consts::ELEVATOR_PID_DEADBAND);
+	CHECK_NEAR(motionMagic.GetError(), 0, 0.5);
+
+	// A manual command takes the leader out of Motion Magic and breaks the follower off, so the
+	// next target is resent even though it didn't change, and the follower rejoins
+	leader.Set(ControlMode::PercentOutput, KG);
+	follower.Set(ControlMode::PercentOutput, KG);
+	CHECK(!motionMagic.IsActive());
+	int numFrames = leader.numFrames;
+	motionMagic.SetTarget(40, KG);
+	CHECK(leader.numFrames == numFrames + 1);
+	CHECK(leader.GetControlMode() == ControlMode::MotionMagic);
+	CHECK(follower.GetControlMode() == ControlMode::Follower && follower.leader == &leader);
+
+	// Moving back down from rest
+	for(int i = 0; i < 2000; i++)
+	{
+		model.Step();
+		motionMagic.SetTarget(10, KG);
+	}
+	CHECK(leader.numFrames == numFrames + 2);
+	CHECK_NEAR(model.position, 10, 0.5);
+
+	return FinishTest("TalonMotionMagicTest");
+}
@@ -0,0 +1,72 @@
+#include "HostTest.h"
+#include <Diagnostics/TraceExporter.h>
+#include <Diagnostics/Tracer.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+typedef std::chrono::steady_clock Clock;
+
+static std::string ReadFile(const std::string& path)
+{
+	std::ifstream file(path);
+	std::stringstream contents;
+	contents << file.rdbuf();
+	return contents.str();
+}
+
+int main()
+{
+	Tracer& tracer = Tracer::GetInstance();
+	tracer.SetEnabled(true);
+	tracer.SetThreadName("Main");
+
+	char directory[] = "/tmp/TraceExporterTestXXXXXX";
+	CHECK(mkdtemp(directory) != nullptr);
+	std::string traceDirectory = std::string(directory) + "/traces";
+
+	std::atomic<int> numFailures(0);
+	TraceExporter exporter(traceDirectory, [&](std::string) { numFailures++; });
+	exporter.Start();
+
+	// Queuing an export returns right away, however many events there are to write
+	for(int i = 0; i < Tracer::EVENTS_PER_THREAD; i++)
+	{
+		ScopedTraceSpan span("Auto Periodic", "loop");
+	}
+	Clock::time_point start = Clock::now();
+	exporter.Export("Auto_0.json");
+	double queueMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	std::printf("Queuing an export: %.3fms\n", queueMs);
+	CHECK(queueMs < 1);
+
+	// Each queued export gets the events recorded since the one before it
+	{
+		ScopedTraceSpan span("Teleop Periodic", "loop");
+	}
+	exporter.Export("Teleop_1.json");
+	exporter.Stop();
+
+	std::string auto0 = ReadFile(traceDirectory + "/Auto_0.json");
+	std::string teleop1 = ReadFile(traceDirectory + "/Teleop_1.json");
+	CHECK(auto0.find("\"Auto Periodic\"") != std::string::npos);
+	CHECK(teleop1.find("\"Auto Periodic\"") == std::string::npos);
+	CHECK(numFailures == 0);
+
+	// A directory that can't be created is reported instead of stopping the thread
+	TraceExporter badExporter(traceDirectory + "/Auto_0.json/traces", [&](std::string) { numFailures++; });
+	badExporter.Start();
+	badExporter.Export("Test_2.json");
+	badExporter.Stop();
+	CHECK(numFailures == 1);
+
+	std::remove((traceDirectory + "/Auto_0.json").c_str());
+	std::remove((traceDirectory + "/Teleop_1.json").c_str());
+	rmdir(traceDirectory.c_str());
+	rmdir(directory);
+
+	return FinishTest("TraceExporterTest");
+}
@@ -0,0 +1,10 @@
+#ifndef HOST_STUB_WPILIB
+#define HOST_STUB_WPILIB
+
+// Lets the host tests build code that includes WPILib.h without using any of it
+namespace frc
+{
+
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef HOST_STUB_PHOENIX
+#define HOST_STUB_PHOENIX
+
+// A stand-in for the parts of the Talon SRX API that the onboard loops use. It records the
+// configuration and the frames it's sent, so a host test can check them and run a model of the
+// Talon's own loop from them.
+// - Everything is in the Talon's native units, as the real Talon sees it
+
+enum class ControlMode
+{
+	PercentOutput,
+	Follower,
+	MotionMagic,
+	Disabled
+};
+
+enum DemandType
+{
+	DemandType_Neutral,
+	DemandType_ArbitraryFeedForward
+};
+
+enum ErrorCode
+{
+	OK
+};
+
+class WPI_TalonSRX
+{
+public:
+	static constexpr int NUM_SLOTS = 4;
+
+	struct SlotGains
+	{
+		double kP = 0;
+		double kI = 0;
+		double kD = 0;
+		double kF = 0;
+	};
+
+	SlotGains slots[NUM_SLOTS];
+	int selectedSlot = 0;
+	int cruiseVelocity = 0;     // Pulses per 100ms
+	int acceleration = 0;       // Pulses per 100ms per second
+	ControlMode controlMode = ControlMode::PercentOutput;
+	double demand = 0;          // Pulses in MotionMagic, output otherwise
+	double arbitraryFeedForward = 0;
+	WPI_TalonSRX* leader = nullptr;
+	int numFrames = 0;          // Calls to Set(), which each send a control frame
+	int closedLoopError = 0;    // Pulses, written by the model of the onboard loop
+
+	ErrorCode Config_kP(int slot, double value, int) { slots[slot].kP = value; return OK; }
+	ErrorCode Config_kI(int slot, double value, int) { slots[slot].kI = value; return OK; }
+	ErrorCode Config_kD(int slot, double value, int) { slots[slot].kD = value; return OK; }
+	ErrorCode Config_kF(int slot, double value, int) { slots[slot].kF = value; return OK; }
+	ErrorCode SelectProfileSlot(int slot, int) { selectedSlot = slot; return OK; }
+	ErrorCode ConfigMotionCruiseVelocity(int value, int) { cruiseVelocity = value; return OK; }
+	ErrorCode ConfigMotionAcceleration(int value, int) { acceleration = value; return OK; }
+
+	void Set(ControlMode mode, double value)
+	{
+		Set(mode, value, DemandType_Neutral, 0);
+	}
+
+	void Set(ControlMode mode, double value, DemandType demandType, double demand1)
+	{
+		controlMode = mode;
+		demand = value;
+		arbitraryFeedForward = demandType == DemandType_ArbitraryFeedForward ? demand1 : 0;
+		leader = nullptr;
+		numFrames++;
+	}
+
+	void Follow(WPI_TalonSRX& master)
+	{
+		controlMode = ControlMode::Follower;
+		leader = &master;
+	}
+
+	ControlMode GetControlMode()
+	{
+		return controlMode;
+	}
+
+	int GetClosedLoopError(int)
+	{
+		return closedLoopError;
+	}
+};
+
+#endif